@@ -533,6 +533,9 @@ void MainWindow::updateInputMode() {
     m_analyzer->setMinimumNumberOfInliers(m_analyzerMinNbInliers);
     ui->videoControls->setVisible(true);
   }
+
+  // the same image pair is analyzed again on every display toggle, video frames never repeat
+  m_imageOperations->computeAlignment.setCacheEnabled(ui->actionInputImage->isChecked());
 }
 
 void MainWindow::updateStereo3DFormat() {
@@ -0,0 +1,76 @@
+#ifndef S3D_BENCHMARKS_BENCHMARK_DATA_H
+#define S3D_BENCHMARKS_BENCHMARK_DATA_H
+
+#include "s3d/geometry/size.h"
+#include "s3d/image/image.h"
+
+#include "stan_synthetic_correspondences.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace s3d {
+namespace benchmarks {
+
+// benchmark arguments are frame sizes by index: 720p, 1080p, 4K
+inline Size frameSize(int64_t index) {
+  static const Size sizes[] = {{1280, 720}, {1920, 1080}, {3840, 2160}};
+  return sizes[index];
+}
+
+// centered homogeneous correspondences of a 1080p frame, 30% outliers
+inline StanSyntheticCorrespondences correspondences(size_t nbCorrespondences,
+                                                    unsigned int seed = 0) {
+  return stan_synthetic_correspondences(
+      {0.002, 0.001, 0.003, 1.5, 1e-6, 0.0, 0.0}, nbCorrespondences, 0.3, seed);
+}
+
+inline std::vector<double> randomValues(size_t size, unsigned int seed = 0) {
+  std::mt19937 mt(seed);
+  std::normal_distribution<double> distribution(0.0, 10.0);
+  std::vector<double> values(size);
+  for (auto& value : values) {
+    value = distribution(mt);
+  }
+  return values;
+}
+
+struct StereoPair {
+  Image<uint8_t> left;
+  Image<uint8_t> right;
+};
+
+// noisy overlapping rectangles (corners for feature detectors, texture for block matching),
+// the right view is the left one moved by shift pixels to the left
+inline StereoPair stereoPair(Size size, int shift = 8, unsigned int seed = 0) {
+  std::mt19937 mt(seed);
+  std::uniform_int_distribution<int> value(0, 255);
+  std::uniform_int_distribution<int> noise(-8, 8);
+  std::uniform_int_distribution<int> x(0, size.getWidth() - 1);
+  std::uniform_int_distribution<int> y(0, size.getHeight() - 1);
+  std::uniform_int_distribution<int> side(4, 40);
+
+  StereoPair pair{Image<uint8_t>(size, uint8_t{128}), Image<uint8_t>(size)};
+  for (int i = 0; i < size.getArea() / 200; ++i) {
+    const int col = x(mt), row = y(mt);
+    const int w = std::min(side(mt), size.getWidth() - col);
+    const int h = std::min(side(mt), size.getHeight() - row);
+    pair.left.block(row, col, h, w).fill(static_cast<uint8_t>(value(mt)));
+  }
+  for (int i = 0; i < size.getArea(); ++i) {
+    pair.left[i] = static_cast<uint8_t>(std::min(std::max(pair.left[i] + noise(mt), 0), 255));
+  }
+  for (int row = 0; row < size.getHeight(); ++row) {
+    for (int col = 0; col < size.getWidth(); ++col) {
+      pair.right(row, col) = pair.left(row, std::min(col + shift, size.getWidth() - 1));
+    }
+  }
+  return pair;
+}
+
+}  // namespace benchmarks
+}  // namespace s3d
+
+#endif  // S3D_BENCHMARKS_BENCHMARK_DATA_H
@@ -0,0 +1,31 @@
+#include "benchmark_data.h"
+
+#include "s3d/video/compression/yuv.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+using s3d::compression::BGR;
+using s3d::compression::RGB;
+using s3d::compression::UYVY;
+using s3d::compression::color_conversion;
+
+template <class OutType>
+static void BM_color_conversion_uyvy(benchmark::State& state) {
+  const auto size = s3d::benchmarks::frameSize(state.range(0));
+  const auto nbPixels = static_cast<size_t>(size.getArea());
+  std::vector<uint8_t> uyvy(nbPixels * 2, 128);
+  std::vector<uint8_t> out(nbPixels * 3);
+
+  color_conversion<UYVY, OutType> cvt;
+  for (auto _ : state) {
+    cvt(std::begin(uyvy), std::end(uyvy), std::begin(out));
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * uyvy.size()));
+}
+BENCHMARK_TEMPLATE(BM_color_conversion_uyvy, BGR)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_color_conversion_uyvy, RGB)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,50 @@
+#include "benchmark_data.h"
+
+#include "s3d/disparity/disparity_algorithm_bm.h"
+#include "s3d/disparity/disparity_algorithm_orb.h"
+#include "s3d/disparity/disparity_analyzer_sgm.h"
+
+#include <benchmark/benchmark.h>
+
+// sizes: half 720p, 720p
+static void disparitySizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Args({640, 360})->Args({1280, 720})->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+static s3d::Size argsSize(const benchmark::State& state) {
+  return {static_cast<int>(state.range(0)), static_cast<int>(state.range(1))};
+}
+
+static void BM_DisparityAnalyzerSGM(benchmark::State& state) {
+  const auto pair = s3d::benchmarks::stereoPair(argsSize(state));
+
+  s3d::DisparityAnalyzerSGM analyzer;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(analyzer.analyze(pair.left, pair.right));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pair.left.size()));
+}
+BENCHMARK(BM_DisparityAnalyzerSGM)->Apply(disparitySizes);
+
+// same algorithms as cuda/benchmarks_cuda_disparity.cpp
+static void BM_DisparityAlgorithmBM(benchmark::State& state) {
+  const auto pair = s3d::benchmarks::stereoPair(argsSize(state));
+
+  s3d::DisparityAlgorithmBM algorithm;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(algorithm.ComputeDisparities(pair.left, pair.right));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pair.left.size()));
+}
+BENCHMARK(BM_DisparityAlgorithmBM)->Apply(disparitySizes);
+
+static void BM_DisparityAlgorithmORB(benchmark::State& state) {
+  const auto pair = s3d::benchmarks::stereoPair(argsSize(state));
+
+  s3d::DisparityAlgorithmORB algorithm;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(algorithm.ComputeDisparities(pair.left, pair.right));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pair.left.size()));
+}
+BENCHMARK(BM_DisparityAlgorithmORB)->Apply(disparitySizes);
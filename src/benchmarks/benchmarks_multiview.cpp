@@ -0,0 +1,87 @@
+#include "benchmark_data.h"
+
+#include "s3d/multiview/sampson_distance_function.h"
+#include "s3d/multiview/stan_batch_estimator.h"
+#include "s3d/multiview/stan_fundamental_matrix_solver.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using s3d::SampsonDistanceFunction;
+using s3d::StanFundamentalMatrixSolver;
+
+static const s3d::StanAlignment model{0.002, 0.001, 0.003, 1.5, 1e-6, 0.0, 0.0};
+
+static void BM_sampson_distance(benchmark::State& state) {
+  const auto c = s3d::benchmarks::correspondences(static_cast<size_t>(state.range(0)));
+  std::vector<double> distances(c.left.size());
+
+  for (auto _ : state) {
+    SampsonDistanceFunction::ComputeDistance(c.left, c.right, model, &distances);
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * c.left.size()));
+}
+BENCHMARK(BM_sampson_distance)->Arg(500)->Arg(2000)->Arg(5000);
+
+static void BM_sampson_distance_soa(benchmark::State& state) {
+  const auto c = s3d::benchmarks::correspondences(static_cast<size_t>(state.range(0)));
+  const SampsonDistanceFunction::SoaSamples soa(c.left, c.right);
+  const auto samples = soa.view();
+  std::vector<double> distances(c.left.size());
+
+  for (auto _ : state) {
+    SampsonDistanceFunction::ComputeDistance(samples, model, 0, samples.size(), distances.data());
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * c.left.size()));
+}
+BENCHMARK(BM_sampson_distance_soa)->Arg(500)->Arg(2000)->Arg(5000);
+
+// minimal sample (5) and least squares refits on all correspondences
+static void BM_stan_solver(benchmark::State& state) {
+  const auto c = s3d::benchmarks::correspondences(static_cast<size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(StanFundamentalMatrixSolver::ComputeModel(c.left, c.right));
+  }
+}
+BENCHMARK(BM_stan_solver)->Arg(5)->Arg(500)->Arg(2000)->Arg(5000);
+
+// frames of 1000 correspondences, items per second are frames per second
+static std::vector<s3d::MatchFinder::Matches> batchFrames(size_t nbFrames) {
+  std::vector<s3d::MatchFinder::Matches> frames;
+  for (size_t i = 0; i < nbFrames; ++i) {
+    frames.push_back(
+        s3d::stan_synthetic_matches(model, 1000, 0.3, static_cast<unsigned int>(i)));
+  }
+  return frames;
+}
+
+// one frame at a time, as DisparityAnalyzerSTAN does
+static void BM_stan_frame_by_frame(benchmark::State& state) {
+  const auto frames = batchFrames(static_cast<size_t>(state.range(0)));
+  s3d::StanBatchEstimator estimator(s3d::Size(1920, 1080));
+  estimator.setNumberOfThreads(1);
+
+  for (auto _ : state) {
+    for (const auto& frame : frames) {
+      benchmark::DoNotOptimize(estimator.estimate({frame}));
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * frames.size()));
+}
+BENCHMARK(BM_stan_frame_by_frame)->Arg(240)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_stan_batch(benchmark::State& state) {
+  const auto frames = batchFrames(static_cast<size_t>(state.range(0)));
+  s3d::StanBatchEstimator estimator(s3d::Size(1920, 1080));
+  estimator.setNumberOfThreads(0);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(estimator.estimate(frames));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * frames.size()));
+}
+BENCHMARK(BM_stan_batch)->Arg(240)->Unit(benchmark::kMillisecond)->UseRealTime();
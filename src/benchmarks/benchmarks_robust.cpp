@@ -0,0 +1,59 @@
+#include "benchmark_data.h"
+
+#include "s3d/multiview/sampson_distance_function.h"
+#include "s3d/multiview/stan_fundamental_matrix_solver.h"
+#include "s3d/robust/lmeds.h"
+#include "s3d/robust/ransac.h"
+#include "s3d/robust/verification.h"
+
+#include <benchmark/benchmark.h>
+
+using s3d::SampsonDistanceFunction;
+using s3d::StanFundamentalMatrixSolver;
+
+// same parameters as DisparityAnalyzerSTAN, fixed seed for comparable runs
+static s3d::robust::Parameters parameters() {
+  auto params = StanFundamentalMatrixSolver::RobustParameters();
+  params.seed = 0;
+  return params;
+}
+
+template <class Estimator>
+static void BM_robust_stan(benchmark::State& state) {
+  const auto c = s3d::benchmarks::correspondences(static_cast<size_t>(state.range(0)));
+
+  size_t nbIterations = 0;
+  for (auto _ : state) {
+    Estimator estimator(parameters());
+    benchmark::DoNotOptimize(estimator(c.left, c.right));
+    nbIterations += estimator.getTotalNumberOfIterations();
+  }
+  state.counters["hypotheses"] =
+      benchmark::Counter(static_cast<double>(nbIterations), benchmark::Counter::kAvgIterations);
+  state.counters["hypotheses_per_second"] =
+      benchmark::Counter(static_cast<double>(nbIterations), benchmark::Counter::kIsRate);
+}
+
+using Ransac = s3d::robust::Ransac<StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+using Lmeds = s3d::robust::Lmeds<StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+using Sampler = s3d::robust::ModelSampler<StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+using RansacSprt = s3d::robust::Ransac<StanFundamentalMatrixSolver,
+                                       SampsonDistanceFunction,
+                                       Sampler,
+                                       s3d::robust::SprtVerification<SampsonDistanceFunction>>;
+
+BENCHMARK_TEMPLATE(BM_robust_stan, Ransac)
+    ->Arg(500)
+    ->Arg(2000)
+    ->Arg(5000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_robust_stan, RansacSprt)
+    ->Arg(500)
+    ->Arg(2000)
+    ->Arg(5000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_robust_stan, Lmeds)
+    ->Arg(500)
+    ->Arg(2000)
+    ->Arg(5000)
+    ->Unit(benchmark::kMillisecond);
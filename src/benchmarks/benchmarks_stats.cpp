@@ -0,0 +1,41 @@
+#include "benchmark_data.h"
+
+#include "s3d/utilities/histogram.h"
+#include "s3d/utilities/stats.h"
+
+#include <benchmark/benchmark.h>
+
+// sizes: number of matches, up to a dense disparity map
+static void statsSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(500)->Arg(5000)->Arg(1920 * 1080)->Unit(benchmark::kMicrosecond);
+}
+
+static void BM_percentile(benchmark::State& state) {
+  const auto values = s3d::benchmarks::randomValues(static_cast<size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s3d::percentile(values, 0.97f));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+BENCHMARK(BM_percentile)->Apply(statsSizes);
+
+static void BM_median(benchmark::State& state) {
+  const auto values = s3d::benchmarks::randomValues(static_cast<size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s3d::median(values));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+BENCHMARK(BM_median)->Apply(statsSizes);
+
+static void BM_histogram(benchmark::State& state) {
+  const auto values = s3d::benchmarks::randomValues(static_cast<size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s3d::Histogram<double>::Compute(values, 100));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+BENCHMARK(BM_histogram)->Apply(statsSizes);
@@ -0,0 +1,27 @@
+#include "benchmark_data.h"
+
+#include "s3dcuda/disparity/disparity_algorithm_bm.h"
+#include "s3dcuda/disparity/disparity_algorithm_orb.h"
+
+#include <benchmark/benchmark.h>
+
+// same sizes and images as the CPU algorithms of benchmarks_disparity.cpp
+static void cudaDisparitySizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Args({640, 360})->Args({1280, 720})->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+template <class Algorithm>
+static void BM_CudaDisparityAlgorithm(benchmark::State& state) {
+  const auto pair = s3d::benchmarks::stereoPair(
+      {static_cast<int>(state.range(0)), static_cast<int>(state.range(1))});
+
+  Algorithm algorithm;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(algorithm.ComputeDisparities(pair.left, pair.right));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pair.left.size()));
+}
+BENCHMARK_TEMPLATE(BM_CudaDisparityAlgorithm, s3d::cuda::DisparityAlgorithmBM)
+    ->Apply(cudaDisparitySizes);
+BENCHMARK_TEMPLATE(BM_CudaDisparityAlgorithm, s3d::cuda::DisparityAlgorithmORB)
+    ->Apply(cudaDisparitySizes);
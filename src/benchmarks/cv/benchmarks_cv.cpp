@@ -0,0 +1,116 @@
+#include "benchmark_data.h"
+
+#include "s3d/cv/features/match_finder_cv.h"
+#include "s3d/cv/rectification/rectifier_cv.h"
+#include "s3d/cv/video/stereo_demuxer/stereo_demuxer_cv_above_below.h"
+#include "s3d/cv/video/stereo_demuxer/stereo_demuxer_cv_side_by_side.h"
+#include "s3d/features/binary_descriptor_matcher.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <benchmark/benchmark.h>
+
+// textured left image, right image shifted by 12 pixels
+static std::pair<cv::Mat, cv::Mat> stereoPair(s3d::Size size) {
+  cv::Mat left(size.getHeight(), size.getWidth(), CV_8UC3);
+  cv::theRNG().state = 0;
+  cv::randu(left, cv::Scalar::all(0), cv::Scalar::all(255));
+  cv::GaussianBlur(left, left, cv::Size(5, 5), 1.5);
+
+  cv::Mat right;
+  cv::Mat shift = (cv::Mat_<double>(2, 3) << 1.0, 0.0, -12.0, 0.0, 1.0, 0.0);
+  cv::warpAffine(left, right, shift, left.size(), cv::INTER_LINEAR, cv::BORDER_REFLECT);
+  return {left, right};
+}
+
+// arguments: frame size index, features per eye, threads (0: all, 1: sequential)
+static void BM_match_finder_cv(benchmark::State& state) {
+  const auto images = stereoPair(s3d::benchmarks::frameSize(state.range(0)));
+
+  s3d::MatchFinderCV matchFinder;
+  matchFinder.setMaxNumberOfFeatures(static_cast<int>(state.range(1)));
+  matchFinder.setNumberOfThreads(static_cast<int>(state.range(2)));
+
+  size_t nbMatches = 0;
+  for (auto _ : state) {
+    auto matches = matchFinder.findMatches(images.first, images.second);
+    nbMatches += matches[0].size();
+  }
+  state.counters["matches"] =
+      benchmark::Counter(static_cast<double>(nbMatches), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_match_finder_cv)
+    ->ArgsProduct({{0, 1, 2}, {500, 5000}, {0}})
+    ->Args({1, 3000, 1})
+    ->Args({1, 3000, 0})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 3000 x 3000 random ORB descriptors, 2 nearest neighbours
+static cv::Mat orbDescriptors(unsigned int seed) {
+  cv::Mat descriptors(3000, 32, CV_8U);
+  cv::theRNG().state = seed;
+  cv::randu(descriptors, 0, 256);
+  return descriptors;
+}
+
+static void BM_knn_match_cv(benchmark::State& state) {
+  const auto queries = orbDescriptors(1);
+  const auto train = orbDescriptors(2);
+
+  auto matcher = cv::DescriptorMatcher::create("BruteForce-Hamming(2)");
+  std::vector<std::vector<cv::DMatch>> matches;
+  for (auto _ : state) {
+    matcher->knnMatch(queries, train, matches, 2);
+    benchmark::DoNotOptimize(matches.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.rows));
+}
+BENCHMARK(BM_knn_match_cv)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_knn_match_s3d(benchmark::State& state) {
+  const auto queries = orbDescriptors(1);
+  const auto train = orbDescriptors(2);
+
+  s3d::BinaryDescriptorMatcher matcher;
+  for (auto _ : state) {
+    auto matches = matcher.knnMatch(queries.ptr<uint8_t>(), static_cast<size_t>(queries.rows),
+                                    train.ptr<uint8_t>(), static_cast<size_t>(train.rows));
+    benchmark::DoNotOptimize(matches.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.rows));
+}
+BENCHMARK(BM_knn_match_s3d)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+template <class Demuxer>
+static void BM_stereo_demuxer_cv(benchmark::State& state) {
+  const auto size = s3d::benchmarks::frameSize(state.range(0));
+  cv::Mat frame(size.getHeight(), size.getWidth(), CV_8UC3, cv::Scalar::all(128));
+
+  Demuxer demuxer(size, s3d::VideoPixelFormat::BGR);
+  for (auto _ : state) {
+    auto images = demuxer.demuxCV(frame);
+    benchmark::DoNotOptimize(images.first.data);
+  }
+}
+BENCHMARK_TEMPLATE(BM_stereo_demuxer_cv, s3d::StereoDemuxerCVSideBySide)
+    ->DenseRange(0, 2)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_stereo_demuxer_cv, s3d::StereoDemuxerCVAboveBelow)
+    ->DenseRange(0, 2)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_rectifier_cv(benchmark::State& state) {
+  const auto image = stereoPair(s3d::benchmarks::frameSize(state.range(0))).first;
+
+  // small roll and vertical offset, as corrected by STAN
+  const cv::Matx33d H(0.9998, -0.0175, 3.0,  //
+                      0.0175, 0.9998, -2.0,  //
+                      0.0, 0.0, 1.0);
+  s3d::RectifierCV rectifier;
+  for (auto _ : state) {
+    auto rectified = rectifier.rectifyCV(image, H);
+    benchmark::DoNotOptimize(rectified.data);
+  }
+}
+BENCHMARK(BM_rectifier_cv)->DenseRange(0, 2)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -3,16 +3,20 @@
 
 #include <s3d/disparity/disparity_analyzer.h>
 
+#include "s3d/cv/features/feature_tracker_cv.h"
 #include "s3d/cv/features/match_finder_surf.h"
 #include "s3d/multiview/sampson_distance_function.h"
 #include "s3d/multiview/stan_fundamental_matrix_solver.h"
 #include "s3d/multiview/stan_results.h"
+#include "s3d/robust/incremental_estimator.h"
 #include "s3d/robust/ransac.h"
 #include "s3d/robust/lmeds.h"
 #include "s3d/utilities/math.h"
+#include "s3d/utilities/stats.h"
 
 #include "s3d/utilities/eigen.h"
 
+#include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 
 #include <gsl/gsl>
@@ -27,6 +31,28 @@ class DisparityAnalyzerSTAN : public DisparityAnalyzer {
   // can alternatively use Lmeds
   using RansacAlgorithmSTAN =
       s3d::robust::Lmeds<s3d::StanFundamentalMatrixSolver, s3d::SampsonDistanceFunction>;
+  using IncrementalAlgorithmSTAN =
+      s3d::robust::IncrementalEstimator<s3d::StanFundamentalMatrixSolver,
+                                        s3d::SampsonDistanceFunction,
+                                        RansacAlgorithmSTAN>;
+
+  // matched points of a frame centered on the image, one array per coordinate (x1, y1 left, x2, y2
+  // right) borrowed by the estimators and the distance kernel, capacity is kept between frames
+  struct Correspondences {
+    void assign(const MatchFinder::Matches& matches, const Eigen::Vector3d& center);
+
+    // compacts in place, inliers index the current points
+    void keep(const s3d::robust::InlierMask& inliers);
+
+    // xRight - xLeft, like compute_disparities
+    void computeDisparities();
+
+    size_t size() const { return points.size(); }
+    SampsonDistanceFunction::SoaView view() const { return points.view(); }
+
+    SampsonDistanceFunction::SoaSamples points{};
+    std::vector<double> disparities{};
+  };
 
   struct Results {
     explicit Results();
@@ -36,9 +62,9 @@ class DisparityAnalyzerSTAN : public DisparityAnalyzer {
                           float widthRatio,
                           RansacAlgorithmSTAN::ModelType model);
 
-    void updatePoints(const std::vector<Eigen::Vector2d>& bestPtsLeft,
-                      const std::vector<Eigen::Vector2d>& bestPtsRight,
-                      std::vector<double> disparities,
+    // points are decentered and brought back to the full resolution (times resizeRatio)
+    void updatePoints(const Correspondences& inliers,
+                      const Eigen::Vector3d& center,
                       float widthRatio,
                       float resizeRatio);
 
@@ -56,6 +82,10 @@ class DisparityAnalyzerSTAN : public DisparityAnalyzer {
   void setMatchFinder(std::unique_ptr<MatchFinderCV> matchFinder);
   void setMaxNumberOfFeatures(int maxNumberOfFeatures);
 
+  // matching restricted around the epipolar lines of the last model found (0: disabled)
+  void setEpipolarBand(float rowTolerance);
+
+  // images are only read, resized copies are made for an analysis scale below 1
   bool analyze(const cv::Mat& left, const cv::Mat& right);
   bool analyze(const Image<uint8_t>& left, const Image<uint8_t>& right) override;
   const std::vector<float>& getDisparitiesPercent() const override;
@@ -63,16 +93,66 @@ class DisparityAnalyzerSTAN : public DisparityAnalyzer {
   const std::vector<Eigen::Vector2f>& getFeaturePointsRight() const override;
   void setMinimumNumberOfInliers(int minNbInliers);
 
+  // video mode: inliers of the previous frame are tracked instead of detected/matched again,
+  // full detection only runs on scene cuts or when too few tracks remain
+  void setFeatureTrackingEnabled(bool enabled);
+  void setMinimumNumberOfTracks(int minNbTracks);
+
+  // video mode: the alignment of the previous frame is scored first and only refined while it
+  // still explains most matches, the full estimation runs after a score drop or a scene cut
+  void setIncrementalEstimationEnabled(bool enabled);
+
+  // images are analyzed at scale * their size (0 < scale <= 1), results (feature points and
+  // alignment) stay in full resolution, images are resized with cv::resize (not taken from the
+  // tracking pyramid, which is built on the result)
+  void setAnalysisScale(float scale);
+
+  // changes with every setter of the analyzer or of its match finder (also when called directly on
+  // the match finder), results of unchanged images stay valid while it does not change
+  uint64_t getSettingsGeneration() const;
+
   // outputs
   Results results;
 
  private:
+  const cv::Mat& scaledForAnalysis(const cv::Mat& image, cv::Mat* scaled) const;
   MatchFinder::Matches findMatches(const cv::Mat& left, const cv::Mat& right);
+  // pyramidsBuilt: the tracker built the pyramids of these images (reused for the next reference)
+  bool trackMatches(const cv::Mat& left,
+                    const cv::Mat& right,
+                    MatchFinder::Matches* matches,
+                    bool* pyramidsBuilt);
+  void keepMatchesConsistentWithModel(const StanAlignment& model,
+                                      const Eigen::Vector3d& center,
+                                      MatchFinder::Matches* matches);
   bool enoughMatches(int nbOfMatches);
   RansacAlgorithmSTAN createRansac(Size imageSize);
+  static s3d::robust::Parameters ransacParameters();
+  static double inlierDistanceThreshold();
 
   std::unique_ptr<MatchFinderCV> matchFinder_{std::make_unique<MatchFinderCV>()};
   int minNbInliers_{4};
+
+  float analysisScale_{1.0f};
+  cv::Mat leftScaled_{};
+  cv::Mat rightScaled_{};
+
+  Correspondences correspondences_{};
+  // results.stan.alignment at the analysis scale
+  StanAlignment analysisAlignment_{};
+  MatchFinder::Matches inlierMatches_{};
+  std::vector<double> distances_{};
+  Quantiles<double> quantiles_{};
+  std::vector<double> disparityRange_{};
+
+  FeatureTrackerCV featureTracker_{};
+  bool trackingEnabled_{false};
+  int minNbTracks_{100};
+
+  bool incrementalEnabled_{false};
+  IncrementalAlgorithmSTAN incrementalEstimator_{ransacParameters()};
+
+  uint64_t settingsGeneration_{0};
 };
 }  // namespace s3d
 
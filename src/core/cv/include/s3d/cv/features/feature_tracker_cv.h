@@ -0,0 +1,72 @@
+#ifndef S3D_CV_FEATURES_FEATURE_TRACKER_CV_H
+#define S3D_CV_FEATURES_FEATURE_TRACKER_CV_H
+
+#include <s3d/features/match_finder.h>
+#include <s3d/image/image_pyramid.h>
+
+#include <opencv2/core/mat.hpp>    // cv::Mat
+#include <opencv2/core/types.hpp>  // cv::Point2f
+
+#include <vector>
+
+namespace s3d {
+
+/**
+ * Propagates left/right correspondences from one frame to the next
+ * with pyramidal Lucas-Kanade optical flow (each eye tracked independently).
+ *
+ * The pyramid of each frame is built once and kept as the reference of the next frame.
+ */
+class FeatureTrackerCV {
+ public:
+  // correspondences found in (leftImage, rightImage), tracked from there on
+  void setReference(const cv::Mat& leftImage,
+                    const cv::Mat& rightImage,
+                    const MatchFinder::Matches& matches);
+
+  // correspondences found in the images of the last track(), whose pyramids are kept as is
+  void setReferencePoints(const MatchFinder::Matches& matches);
+
+  // correspondences that survived in both eyes, in the new images coordinates
+  MatchFinder::Matches track(const cv::Mat& leftImage, const cv::Mat& rightImage);
+
+  void reset();
+
+  bool hasReference() const;
+
+  // pyramids of the last images given to setReference() or track() are available
+  bool hasPyramids() const;
+
+  // most correspondences lost at once: probably not the same shot anymore
+  bool sceneCutDetected() const;
+
+  void setSceneCutSurvivalRatio(float ratio);
+
+ private:
+  static cv::Mat toGray(const cv::Mat& image);
+
+  void buildPyramid(const cv::Mat& image, ImagePyramid* pyramid);
+
+  void trackPoints(const ImagePyramid& previousPyramid,
+                   const ImagePyramid& pyramid,
+                   const std::vector<cv::Point2f>& previousPoints,
+                   std::vector<cv::Point2f>* points,
+                   std::vector<uchar>* status);
+
+  ImagePyramid previousLeft_{};
+  ImagePyramid previousRight_{};
+  ImagePyramid currentLeft_{};
+  ImagePyramid currentRight_{};
+  std::vector<cv::Point2f> pointsLeft_{};
+  std::vector<cv::Point2f> pointsRight_{};
+
+  float survivalRatio_{1.0f};
+  float sceneCutSurvivalRatio_{0.5f};
+
+  int windowSize_{21};
+  int maxPyramidLevel_{3};
+};
+
+}  // namespace s3d
+
+#endif  // S3D_CV_FEATURES_FEATURE_TRACKER_CV_H
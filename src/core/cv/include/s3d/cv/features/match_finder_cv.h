@@ -8,6 +8,8 @@
 
 #include "s3d/utilities/eigen.h"
 
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace cv {
@@ -28,20 +30,63 @@ class MatchFinderCV : public MatchFinder {
 
   void setMaxNumberOfFeatures(int maxNumberOfFeatures);
 
+  // keypoints are selected per cell of a nbCols x nbRows grid to spread them over the image
+  // maxPerCell == 0: budget evenly split between cells, leftovers go to the best remaining ones
+  void setKeypointGrid(int nbCols, int nbRows, int maxPerCell = 0);
+
+  // detection and description run in parallel on nbCols x nbRows tiles, each grown by overlap
+  // pixels for context, with an even share of the features budget per tile
+  void setDetectionTiles(int nbCols, int nbRows, int overlap = 32);
+
+  // 0: use all available threads, 1: run sequentially
+  void setNumberOfThreads(int nbThreads);
+
+  // only compares right keypoints within rowTolerance pixels of the left keypoint row,
+  // or of its epipolar line when a prior is set (0: full kNN matching)
+  void setEpipolarBand(float rowTolerance);
+
+  // F such that xRight^T * F * xLeft = 0, in image coordinates (e.g. previous frame model)
+  void setEpipolarPrior(const Eigen::Matrix3d& F);
+  void clearEpipolarPrior();
+
+  // incremented by every setter changing the matches found (not by the epipolar prior, which is
+  // per frame state)
+  uint64_t getSettingsGeneration() const;
+
   MatchFinder::Matches findMatches(const std::vector<Image<uint8_t>>& images) override;
   Features findFeatures(const Image<uint8_t>& img);
 
   MatchFinder::Matches findMatches(const cv::Mat& imageLeft, const cv::Mat& imageRight);
   Features findFeatures(const cv::Mat& img);
 
+  // left and right features are extracted concurrently
+  std::pair<Features, Features> findFeatures(const cv::Mat& imageLeft, const cv::Mat& imageRight);
+
   MatchFinder::Matches matchFeatures(const Features& leftFeatures, const Features& rightFeatures);
 
+  // 256 bits binary descriptors (e.g. ORB) are matched with the SIMD s3d matcher
+  MatchFinder::Matches matchBinaryFeatures(const Features& leftFeatures,
+                                           const Features& rightFeatures);
+
+  MatchFinder::Matches matchFeaturesInEpipolarBand(const Features& leftFeatures,
+                                                   const Features& rightFeatures);
+
   std::vector<cv::KeyPoint> keepBestKeypointsFromResponse(const std::vector<cv::KeyPoint>& keypoints, size_t numberToKeep);
 
+  // linear time, keypoints are returned grouped by cell (not sorted by response)
+  static std::vector<cv::KeyPoint> keepBestKeypointsInGrid(std::vector<cv::KeyPoint> keypoints,
+                                                           cv::Size imageSize,
+                                                           size_t numberToKeep,
+                                                           int nbCols,
+                                                           int nbRows,
+                                                           size_t maxPerCell = 0);
+
   double matchesMinDistance(Matches matches) const;
 
   static double computeThreshold(int imageWidth, int imageHeight);
 
+  static bool isBinary256Descriptors(const cv::Mat& descriptors);
+
   virtual cv::Ptr<cv::Feature2D> createFeatureDetector();
 
   virtual cv::Ptr<cv::DescriptorMatcher> createDescriptorMatcher();
@@ -56,7 +101,45 @@ class MatchFinderCV : public MatchFinder {
                                  const cv::Mat& /*imgRight*/,
                                  const MatchFinder::Matches& /*matches*/) {}
 
+  // detectors (one per eye and tile) and matchers (one per chunk of queries, at most one per
+  // thread) are created once and reused, each is used by a single thread at a time, call this when
+  // their configuration changes so they are recreated on next use
+  void resetInstances();
+
   size_t maxNbFeatures_{3000}; // todo: set this somewhere else
+  size_t nbThreads_{0};
+
+  int gridCols_{1};
+  int gridRows_{1};
+  size_t maxKeypointsPerCell_{0};
+
+  int tileCols_{1};
+  int tileRows_{1};
+  int tileOverlap_{32};
+
+  uint64_t settingsGeneration_{0};
+
+  float epipolarBand_{0.0f};
+  bool hasEpipolarPrior_{false};
+  Eigen::Matrix3d epipolarPrior_{Eigen::Matrix3d::Zero()};
+
+ private:
+  enum { LEFT_EYE = 0, RIGHT_EYE = 1, NB_EYES = 2 };
+
+  // a single detector means the whole image is used
+  Features findFeatures(const cv::Mat& img, const std::vector<cv::Feature2D*>& featureDetectors);
+  Features findFeaturesInTiles(const cv::Mat& img,
+                               const std::vector<cv::Feature2D*>& featureDetectors);
+
+  // one detector per tile
+  std::vector<cv::Feature2D*> getFeatureDetectors(size_t eye);
+  // one matcher per chunk of queries
+  std::vector<cv::DescriptorMatcher*> getDescriptorMatchers(size_t nbMatchers);
+  // indexes descriptors, unless the matcher is already trained on them
+  static void trainDescriptorMatcher(cv::DescriptorMatcher* matcher, const cv::Mat& descriptors);
+
+  std::vector<cv::Ptr<cv::Feature2D>> featureDetectors_[NB_EYES];
+  std::vector<cv::Ptr<cv::DescriptorMatcher>> descriptorMatchers_;
 };
 
 /**
@@ -3,6 +3,9 @@
 
 #include "image_operation.h"
 
+#include <cstdint>
+#include <memory>
+
 namespace s3d {
   class DisparityAnalyzerSTAN;
   struct StanResults;
@@ -18,13 +21,26 @@ namespace image_operation {
 class ComputeAlignment : public ImageOperation {
 public:
   explicit ComputeAlignment(gsl::not_null<s3d::DisparityAnalyzerSTAN*> disparityAnalyzer);
+  ~ComputeAlignment();
+
+  // same images and analyzer settings as last time: previous results are reused (e.g. display
+  // only toggles in image mode), disabled by default since video frames never hit
+  void setCacheEnabled(bool enabled);
+  void clearCache();
 
 private:
   bool applyOnImage(cv::Mat* leftImage, cv::Mat* rightImage, StanResults* results) override;
   bool disparityRangeWideEnough();
+  uint64_t computeCacheKey(const cv::Mat& leftImage, const cv::Mat& rightImage) const;
 
   float minDisparityRange_{0.1f};
   s3d::DisparityAnalyzerSTAN* disparityAnalyzer_;
+
+  // analyzer outputs of the last images
+  struct Cache;
+
+  bool cacheEnabled_{false};
+  std::unique_ptr<Cache> cache_;
 };
 
 } // namespace s3d
@@ -2,6 +2,7 @@
 #define S3D_CV_UTILITIES_CV_H
 
 #include "s3d/image/image.h"
+#include "s3d/image/image_pyramid.h"
 #include "s3d/utilities/random_color_generator.h"
 #include "s3d/video/video_frame.h"
 #include "s3d/video/video_types.h"
@@ -32,6 +33,26 @@ inline cv::Mat image2cv(const Image<uint8_t>& img) {
   return cvImg;
 }
 
+// does not copy data, read only view that must not outlive img
+inline cv::Mat image2cvView(const Image<uint8_t>& img) {
+  return cv::Mat(img.height(), img.width(), CV_8U, const_cast<uchar*>(img.data()));
+}
+
+// does not copy data, levels are ROIs so that their border can be located (cv::Mat::locateROI)
+inline std::vector<cv::Mat> pyramid2cv(const ImagePyramid& pyramid) {
+  std::vector<cv::Mat> levels;
+  const int border = pyramid.border();
+  for (int i = 0; i < pyramid.nbLevels(); ++i) {
+    const Size size = pyramid.levelSize(i);
+    const size_t stride = pyramid.levelStride(i);
+    auto* first = const_cast<uchar*>(pyramid.levelData(i)) - border * stride - border;
+    cv::Mat withBorder(size.getHeight() + 2 * border, size.getWidth() + 2 * border, CV_8U, first,
+                       stride);
+    levels.push_back(withBorder(cv::Rect(border, border, size.getWidth(), size.getHeight())));
+  }
+  return levels;
+}
+
 inline int nbChannelsToMatType(int nbChannels) {
   int imgType = CV_8U;
   switch (nbChannels) {
@@ -3,12 +3,14 @@
 #include <s3d/cv/features/match_finder_surf.h>
 #include <s3d/cv/utilities/cv.h>
 #include <s3d/disparity/utilities.h>
-#include <s3d/math.h>
+#include <s3d/utilities/hash.h>
 #include <s3d/utilities/histogram.h>
 
 #include <opencv2/opencv.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 namespace s3d {
 
@@ -25,33 +27,72 @@ void DisparityAnalyzerSTAN::Results::updateParameters(double minDisparity,
   stan.alignment = model;
 }
 
-void DisparityAnalyzerSTAN::Results::updatePoints(const std::vector<Eigen::Vector2d>& bestPtsLeft,
-                                                  const std::vector<Eigen::Vector2d>& bestPtsRight,
-                                                  std::vector<double> disparities,
+void DisparityAnalyzerSTAN::Results::updatePoints(const Correspondences& inliers,
+                                                  const Eigen::Vector3d& center,
                                                   float widthRatio,
                                                   float resizeRatio) {
-  assert(bestPtsLeft.size() == bestPtsRight.size());
+  assert(inliers.disparities.size() == inliers.size());
 
   stan.featuresLeft.clear();
   stan.featuresRight.clear();
 
   disparitiesPercent.clear();
-  for (size_t i = 0; i < bestPtsLeft.size(); ++i) {
+  for (size_t i = 0; i < inliers.size(); ++i) {
     // filter out extreme percentiles
-    if (minDisparityPercent / widthRatio <= disparities[i] &&
-        disparities[i] <= maxDisparityPercent / widthRatio) {
+    const double disparity = inliers.disparities[i];
+    if (minDisparityPercent / widthRatio <= disparity &&
+        disparity <= maxDisparityPercent / widthRatio) {
 
-      stan.featuresLeft.emplace_back(bestPtsLeft[i].x() * resizeRatio,
-                                            bestPtsLeft[i].y() * resizeRatio);
+      stan.featuresLeft.emplace_back((inliers.points.x1[i] + center.x()) * resizeRatio,
+                                     (inliers.points.y1[i] + center.y()) * resizeRatio);
 
-      stan.featuresRight.emplace_back(bestPtsRight[i].x() * resizeRatio,
-                                             bestPtsRight[i].y() * resizeRatio);
+      stan.featuresRight.emplace_back((inliers.points.x2[i] + center.x()) * resizeRatio,
+                                      (inliers.points.y2[i] + center.y()) * resizeRatio);
 
-      disparitiesPercent.push_back(static_cast<float>(disparities[i] * widthRatio));
+      disparitiesPercent.push_back(static_cast<float>(disparity * widthRatio));
     }
   }
 }
 
+void DisparityAnalyzerSTAN::Correspondences::assign(const MatchFinder::Matches& matches,
+                                                    const Eigen::Vector3d& center) {
+  assert(matches.size() == 2 && matches[0].size() == matches[1].size());
+
+  const size_t nbMatches = matches[0].size();
+  points.resize(nbMatches);
+  for (size_t i = 0; i < nbMatches; ++i) {
+    points.x1[i] = matches[0][i].x() - center.x();
+    points.y1[i] = matches[0][i].y() - center.y();
+    points.x2[i] = matches[1][i].x() - center.x();
+    points.y2[i] = matches[1][i].y() - center.y();
+  }
+  disparities.clear();
+}
+
+void DisparityAnalyzerSTAN::Correspondences::keep(const s3d::robust::InlierMask& inliers) {
+  assert(inliers.size() == size());
+
+  // set bits are increasing, points only move towards the front
+  size_t nbKept = 0;
+  inliers.forEachSet([this, &nbKept](size_t i) {
+    points.x1[nbKept] = points.x1[i];
+    points.y1[nbKept] = points.y1[i];
+    points.x2[nbKept] = points.x2[i];
+    points.y2[nbKept] = points.y2[i];
+    ++nbKept;
+  });
+  points.resize(nbKept);
+  disparities.clear();
+}
+
+void DisparityAnalyzerSTAN::Correspondences::computeDisparities() {
+  // centering cancels out
+  disparities.resize(size());
+  for (size_t i = 0; i < size(); ++i) {
+    disparities[i] = points.x2[i] - points.x1[i];
+  }
+}
+
 DisparityAnalyzerSTAN::DisparityAnalyzerSTAN() : results{} {}
 
 gsl::owner<DisparityAnalyzerSTAN*> DisparityAnalyzerSTAN::clone() const {
@@ -59,80 +100,103 @@ gsl::owner<DisparityAnalyzerSTAN*> DisparityAnalyzerSTAN::clone() const {
 }
 
 void DisparityAnalyzerSTAN::setMatchFinder(std::unique_ptr<MatchFinderCV> matchFinder) {
+  ++settingsGeneration_;
   matchFinder_ = std::move(matchFinder);
 }
 
 void DisparityAnalyzerSTAN::setMaxNumberOfFeatures(int maxNumberOfFeatures) {
+  ++settingsGeneration_;
   matchFinder_->setMaxNumberOfFeatures(maxNumberOfFeatures);
 }
 
+void DisparityAnalyzerSTAN::setEpipolarBand(float rowTolerance) {
+  ++settingsGeneration_;
+  matchFinder_->setEpipolarBand(rowTolerance);
+}
+
 bool DisparityAnalyzerSTAN::analyze(const Image<uint8_t>& left, const Image<uint8_t>& right) {
-  return analyze(image2cv(left), image2cv(right));
+  return analyze(image2cvView(left), image2cvView(right));
 }
 
 bool DisparityAnalyzerSTAN::analyze(const cv::Mat& leftImage, const cv::Mat& rightImage) {
-  // copy images
-  cv::Mat leftOrig = leftImage.clone();
-  cv::Mat rightOrig = rightImage.clone();
-
-  // resize images
-  constexpr float resizeRatio = 1.0f;
-  resizeMat(&leftOrig, 1.0f / resizeRatio);
-  resizeMat(&rightOrig, 1.0f / resizeRatio);
-
-  // find matches
-  auto matches = findMatches(leftOrig, rightOrig);
+  // borrowed as is at full scale, resized in reused buffers otherwise
+  const cv::Mat& left = scaledForAnalysis(leftImage, &leftScaled_);
+  const cv::Mat& right = scaledForAnalysis(rightImage, &rightScaled_);
+
+  // find matches (tracked from the previous frame when possible)
+  MatchFinder::Matches matches;
+  bool pyramidsBuilt = false;
+  if (!trackMatches(left, right, &matches, &pyramidsBuilt)) {
+    matches = findMatches(left, right);
+  }
 
-  // make sure that we have enough matches to run ransac
+  // make sure that we have enough matches to run ransac, the band around a stale prior may be the
+  // cause, the next frame is matched without it
   if (matches[0].size() < s3d::robust::estimation_algorithm_traits<s3d::StanFundamentalMatrixSolver>::MIN_NB_SAMPLES) {
+    featureTracker_.reset();
+    matchFinder_->clearEpipolarPrior();
     return false;
   }
 
-  // to homogeneous
-  std::vector<Eigen::Vector3d> pts1h, pts2h;
-  s3d::toHomogeneous2D(matches[0], &pts1h);
-  s3d::toHomogeneous2D(matches[1], &pts2h);
-
-  // center values
-  Eigen::Vector3d center(leftImage.cols/2, leftImage.rows/2, 0.0);
-  s3d::center_values(std::begin(pts1h), std::end(pts1h), std::begin(pts1h), center);
-  s3d::center_values(std::begin(pts2h), std::end(pts2h), std::begin(pts2h), center);
-
-  // solve F with RANSAC
-  auto ransac = createRansac(Size(leftOrig.rows, leftOrig.cols));
+  // to homogeneous, centered on the image
+  const Eigen::Vector3d center(left.cols / 2, left.rows / 2, 0.0);
+  correspondences_.assign(matches, center);
 
+  // solve F with RANSAC, warm started from the previous frame in incremental mode, then keep the
+  // inliers in place (the estimators borrow the correspondences, nothing is copied)
   RansacAlgorithmSTAN::ModelType model;
   try {
-    model = ransac(pts1h, pts2h);
+    if (incrementalEnabled_) {
+      model = incrementalEstimator_(correspondences_.view());
+      correspondences_.keep(incrementalEstimator_.getBestInlierMask());
+    } else {
+      auto ransac = createRansac(Size(left.cols, left.rows));
+      model = ransac(correspondences_.view());
+      correspondences_.keep(ransac.getBestInlierMask());
+    }
   } catch (const s3d::robust::NotEnoughInliersFound& /*exception*/) {
+    featureTracker_.reset();
+    matchFinder_->clearEpipolarPrior();
     return false;
   }
 
-//  std::cout << "Nb iterations: " << ransac.getTotalNumberOfIterations() << '\n';
-
-  // filter inliers
-  std::vector<Eigen::Vector3d> bestPts1h, bestPts2h;
-  std::tie(bestPts1h, bestPts2h) = ransac.getBestInlierSamples();
-
-  // decenter inliers
-  s3d::center_values(std::begin(bestPts1h), std::end(bestPts1h), std::begin(bestPts1h), -center);
-  s3d::center_values(std::begin(bestPts2h), std::end(bestPts2h), std::begin(bestPts2h), -center);
+  // epipolar band matching of the next frame is centered on this model
+  matchFinder_->setEpipolarPrior(StanFundamentalMatrixSolver::CenteredFundamentalMatrixFromAlignment(
+      model, Size(left.cols, left.rows)));
 
   // compute disparity range
-  std::vector<Eigen::Vector2d> bestPts1, bestPts2;
-  s3d::toEuclidian2DTruncate(bestPts1h, &bestPts1);
-  s3d::toEuclidian2DTruncate(bestPts2h, &bestPts2);
-  std::vector<double> disparities;
-  s3d::compute_disparities(bestPts1, bestPts2, back_inserter(disparities));
+  correspondences_.computeDisparities();
   double minDisparity, maxDisparity;
-  std::tie(minDisparity, maxDisparity) = s3d::disparity_range(disparities);
+  std::tie(minDisparity, maxDisparity) =
+      s3d::disparity_range(correspondences_.disparities, &quantiles_, &disparityRange_);
+
+  // inliers are tracked in the next frame
+  if (trackingEnabled_) {
+    const auto& points = correspondences_.points;
+    inlierMatches_.resize(2);
+    inlierMatches_[0].resize(points.size());
+    inlierMatches_[1].resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      inlierMatches_[0][i] << points.x1[i] + center.x(), points.y1[i] + center.y();
+      inlierMatches_[1][i] << points.x2[i] + center.x(), points.y2[i] + center.y();
+    }
+    if (pyramidsBuilt) {
+      featureTracker_.setReferencePoints(inlierMatches_);
+    } else {
+      featureTracker_.setReference(left, right, inlierMatches_);
+    }
+  }
 
-  if (enoughMatches(static_cast<int>(bestPts1.size())))
+  if (enoughMatches(static_cast<int>(correspondences_.size())))
   {
-    // Set outputs (moving average of smoothingFactor_)
-    const float widthRatio = 100.0f / static_cast<float>(leftOrig.cols);
-    results.updateParameters(minDisparity, maxDisparity, widthRatio, model);
-    results.updatePoints(bestPts1, bestPts2, disparities, widthRatio, resizeRatio);
+    // Set outputs (moving average of smoothingFactor_), the model found at the analysis scale is
+    // kept for the tracked matches of the next frame
+    analysisAlignment_ = model;
+    const float widthRatio = 100.0f / static_cast<float>(left.cols);
+    const auto fullResolutionModel =
+        StanFundamentalMatrixSolver::ScaledAlignment(model, 1.0 / analysisScale_);
+    results.updateParameters(minDisparity, maxDisparity, widthRatio, fullResolutionModel);
+    results.updatePoints(correspondences_, center, widthRatio, 1.0f / analysisScale_);
   }
 
   return enoughMatches(static_cast<int>(results.stan.featuresLeft.size()));
@@ -150,6 +214,17 @@ const std::vector<Eigen::Vector2f>& DisparityAnalyzerSTAN::getFeaturePointsRight
   return results.stan.featuresRight;
 }
 
+const cv::Mat& DisparityAnalyzerSTAN::scaledForAnalysis(const cv::Mat& image,
+                                                        cv::Mat* scaled) const {
+  if (analysisScale_ == 1.0f) {
+    return image;
+  }
+  const cv::Size size(std::max(1, static_cast<int>(std::lround(image.cols * analysisScale_))),
+                      std::max(1, static_cast<int>(std::lround(image.rows * analysisScale_))));
+  cv::resize(image, *scaled, size, 0.0, 0.0, cv::INTER_AREA);
+  return *scaled;
+}
+
 s3d::MatchFinder::Matches DisparityAnalyzerSTAN::findMatches(const cv::Mat& left,
                                                              const cv::Mat& right) {
   // find matches
@@ -159,22 +234,111 @@ s3d::MatchFinder::Matches DisparityAnalyzerSTAN::findMatches(const cv::Mat& left
   return matches;
 }
 
+bool DisparityAnalyzerSTAN::trackMatches(const cv::Mat& left,
+                                         const cv::Mat& right,
+                                         MatchFinder::Matches* matches,
+                                         bool* pyramidsBuilt) {
+  *pyramidsBuilt = false;
+  if (!trackingEnabled_ || !featureTracker_.hasReference()) {
+    return false;
+  }
+
+  *matches = featureTracker_.track(left, right);
+  if (featureTracker_.sceneCutDetected()) {
+    featureTracker_.reset();
+    incrementalEstimator_.reset();
+    return false;
+  }
+  *pyramidsBuilt = true;
+
+  // tracks drifting away from the previous model are dropped, except in incremental mode: there
+  // the estimator compares the inlier ratio of the previous model on all tracks with the ratio of
+  // its last full estimation, filtered tracks would keep it close to 1 even when the rig moved
+  if (!incrementalEnabled_) {
+    Eigen::Vector3d center(left.cols / 2, left.rows / 2, 0.0);
+    keepMatchesConsistentWithModel(analysisAlignment_, center, matches);
+  }
+
+  return (*matches)[0].size() >= static_cast<size_t>(minNbTracks_);
+}
+
+void DisparityAnalyzerSTAN::keepMatchesConsistentWithModel(const StanAlignment& model,
+                                                           const Eigen::Vector3d& center,
+                                                           MatchFinder::Matches* matches) {
+  correspondences_.assign(*matches, center);
+  distances_.resize(correspondences_.size());
+  SampsonDistanceFunction::ComputeDistance(
+      correspondences_.view(), model, 0, correspondences_.size(), distances_.data());
+
+  // compacted in place, the order is kept
+  auto& left = (*matches)[0];
+  auto& right = (*matches)[1];
+  size_t nbConsistent = 0;
+  for (size_t i = 0; i < distances_.size(); ++i) {
+    if (distances_[i] <= inlierDistanceThreshold()) {
+      left[nbConsistent] = left[i];
+      right[nbConsistent] = right[i];
+      ++nbConsistent;
+    }
+  }
+  left.resize(nbConsistent);
+  right.resize(nbConsistent);
+  matches->qualities.clear();
+}
+
 bool DisparityAnalyzerSTAN::enoughMatches(int nbOfMatches) {
   return nbOfMatches >= minNbInliers_;
 }
 
 DisparityAnalyzerSTAN::RansacAlgorithmSTAN DisparityAnalyzerSTAN::createRansac(Size imageSize) {
-  float expectedStd = 0.5f;
+  return DisparityAnalyzerSTAN::RansacAlgorithmSTAN(ransacParameters());
+}
 
-  s3d::robust::Parameters params;
-  params.nbTrials = 500;
-  params.distanceThreshold = sqrt(3.84*expectedStd*expectedStd);
+// static
+s3d::robust::Parameters DisparityAnalyzerSTAN::ransacParameters() {
+  return StanFundamentalMatrixSolver::RobustParameters();
+}
 
-  return DisparityAnalyzerSTAN::RansacAlgorithmSTAN(params);
+// static
+double DisparityAnalyzerSTAN::inlierDistanceThreshold() {
+  return ransacParameters().distanceThreshold;
 }
 
 void DisparityAnalyzerSTAN::setMinimumNumberOfInliers(int minNbInliers) {
+  ++settingsGeneration_;
   minNbInliers_ = minNbInliers;
 }
 
+void DisparityAnalyzerSTAN::setFeatureTrackingEnabled(bool enabled) {
+  ++settingsGeneration_;
+  trackingEnabled_ = enabled;
+  featureTracker_.reset();
+}
+
+void DisparityAnalyzerSTAN::setMinimumNumberOfTracks(int minNbTracks) {
+  ++settingsGeneration_;
+  minNbTracks_ = minNbTracks;
+}
+
+void DisparityAnalyzerSTAN::setIncrementalEstimationEnabled(bool enabled) {
+  ++settingsGeneration_;
+  incrementalEnabled_ = enabled;
+  incrementalEstimator_.reset();
+}
+
+void DisparityAnalyzerSTAN::setAnalysisScale(float scale) {
+  assert(0.0f < scale && scale <= 1.0f);
+  ++settingsGeneration_;
+  analysisScale_ = scale;
+
+  // tracks, priors and models of the previous scale do not apply anymore
+  featureTracker_.reset();
+  matchFinder_->clearEpipolarPrior();
+  incrementalEstimator_.reset();
+}
+
+uint64_t DisparityAnalyzerSTAN::getSettingsGeneration() const {
+  return hash_combine(settingsGeneration_, matchFinder_->getSettingsGeneration());
+}
+
 }  // namespace s3d
@@ -0,0 +1,142 @@
+#include "s3d/cv/features/feature_tracker_cv.h"
+
+#include "s3d/cv/utilities/cv.h"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+
+#include <cassert>
+#include <utility>
+
+namespace s3d {
+
+void FeatureTrackerCV::setReference(const cv::Mat& leftImage,
+                                    const cv::Mat& rightImage,
+                                    const MatchFinder::Matches& matches) {
+  assert(matches.size() == 2 && matches[0].size() == matches[1].size());
+
+  buildPyramid(leftImage, &previousLeft_);
+  buildPyramid(rightImage, &previousRight_);
+  setReferencePoints(matches);
+}
+
+void FeatureTrackerCV::setReferencePoints(const MatchFinder::Matches& matches) {
+  assert(matches.size() == 2 && matches[0].size() == matches[1].size());
+  assert(hasPyramids());
+
+  pointsLeft_.clear();
+  pointsRight_.clear();
+  for (size_t i = 0; i < matches[0].size(); ++i) {
+    pointsLeft_.emplace_back(static_cast<float>(matches[0][i].x()),
+                             static_cast<float>(matches[0][i].y()));
+    pointsRight_.emplace_back(static_cast<float>(matches[1][i].x()),
+                              static_cast<float>(matches[1][i].y()));
+  }
+}
+
+MatchFinder::Matches FeatureTrackerCV::track(const cv::Mat& leftImage, const cv::Mat& rightImage) {
+  MatchFinder::Matches matches{std::vector<MatchFinder::Position>{},
+                               std::vector<MatchFinder::Position>{}};
+  if (!hasReference()) {
+    return matches;
+  }
+
+  buildPyramid(leftImage, &currentLeft_);
+  buildPyramid(rightImage, &currentRight_);
+
+  std::vector<cv::Point2f> nextLeft, nextRight;
+  std::vector<uchar> statusLeft, statusRight;
+  trackPoints(previousLeft_, currentLeft_, pointsLeft_, &nextLeft, &statusLeft);
+  trackPoints(previousRight_, currentRight_, pointsRight_, &nextRight, &statusRight);
+
+  // surviving points are tracked from their new positions in the next frame
+  const cv::Rect2f imageRect(0.0f, 0.0f, static_cast<float>(leftImage.cols),
+                             static_cast<float>(leftImage.rows));
+  const size_t nbPoints = pointsLeft_.size();
+  size_t nbSurvivors = 0;
+  for (size_t i = 0; i < nbPoints; ++i) {
+    if (statusLeft[i] != 0 && statusRight[i] != 0 && imageRect.contains(nextLeft[i]) &&
+        imageRect.contains(nextRight[i])) {
+      matches[0].emplace_back(nextLeft[i].x, nextLeft[i].y);
+      matches[1].emplace_back(nextRight[i].x, nextRight[i].y);
+      pointsLeft_[nbSurvivors] = nextLeft[i];
+      pointsRight_[nbSurvivors] = nextRight[i];
+      ++nbSurvivors;
+    }
+  }
+  pointsLeft_.resize(nbSurvivors);
+  pointsRight_.resize(nbSurvivors);
+
+  survivalRatio_ = static_cast<float>(nbSurvivors) / static_cast<float>(nbPoints);
+
+  // next frame is tracked from this one, its pyramids are reused as is
+  std::swap(previousLeft_, currentLeft_);
+  std::swap(previousRight_, currentRight_);
+  return matches;
+}
+
+void FeatureTrackerCV::reset() {
+  previousLeft_.clear();
+  previousRight_.clear();
+  pointsLeft_.clear();
+  pointsRight_.clear();
+  survivalRatio_ = 1.0f;
+}
+
+bool FeatureTrackerCV::hasReference() const {
+  return hasPyramids() && !pointsLeft_.empty();
+}
+
+bool FeatureTrackerCV::hasPyramids() const {
+  return previousLeft_.nbLevels() > 0;
+}
+
+bool FeatureTrackerCV::sceneCutDetected() const {
+  return survivalRatio_ < sceneCutSurvivalRatio_;
+}
+
+void FeatureTrackerCV::setSceneCutSurvivalRatio(float ratio) {
+  sceneCutSurvivalRatio_ = ratio;
+}
+
+// static
+cv::Mat FeatureTrackerCV::toGray(const cv::Mat& image) {
+  cv::Mat gray;
+  switch (image.channels()) {
+    case 3:
+      cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+      break;
+    case 4:
+      cv::cvtColor(image, gray, cv::COLOR_BGRA2GRAY);
+      break;
+    default:
+      gray = image;
+      break;
+  }
+  return gray;
+}
+
+void FeatureTrackerCV::buildPyramid(const cv::Mat& image, ImagePyramid* pyramid) {
+  // border needed by calcOpticalFlowPyrLK around each level
+  cv::Mat gray = toGray(image);
+  pyramid->build(gray.ptr<uint8_t>(), Size(gray.cols, gray.rows), gray.step, maxPyramidLevel_ + 1,
+                 windowSize_ + 1);
+}
+
+void FeatureTrackerCV::trackPoints(const ImagePyramid& previousPyramid,
+                                   const ImagePyramid& pyramid,
+                                   const std::vector<cv::Point2f>& previousPoints,
+                                   std::vector<cv::Point2f>* points,
+                                   std::vector<uchar>* status) {
+  std::vector<float> errors;
+  cv::calcOpticalFlowPyrLK(pyramid2cv(previousPyramid),
+                           pyramid2cv(pyramid),
+                           previousPoints,
+                           *points,
+                           *status,
+                           errors,
+                           cv::Size(windowSize_, windowSize_),
+                           maxPyramidLevel_);
+}
+
+}  // namespace s3d
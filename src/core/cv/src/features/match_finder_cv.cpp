@@ -2,15 +2,40 @@
 
 #include "s3d/cv/utilities/cv.h"
 
+#include "s3d/concurrency/thread_pool.h"
+#include "s3d/features/binary_descriptor_matcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
 namespace s3d {
 
 using FeaturesCV = MatchFinderCV::Features;
 using MatchesCV = MatchFinderCV::Matches;
 
+namespace {
+
+// quality is the ratio test margin: 1 for an unambiguous match, 0 when both candidates are equal
+void addMatch(const cv::Point2f& ptLeft,
+              const cv::Point2f& ptRight,
+              double bestDistance,
+              double secondBestDistance,
+              MatchFinder::Matches* matches) {
+  (*matches)[0].emplace_back(ptLeft.x, ptLeft.y);
+  (*matches)[1].emplace_back(ptRight.x, ptRight.y);
+  matches->qualities.push_back(
+      secondBestDistance > 0.0 ? 1.0 - bestDistance / secondBestDistance : 0.0);
+}
+
+}  // namespace
+
 MatchFinder::Matches MatchFinderCV::findMatches(const cv::Mat& imageLeft,
                                                 const cv::Mat& imageRight) {
-  auto featuresLeft = findFeatures(imageLeft);
-  auto featuresRight = findFeatures(imageRight);
+  FeaturesCV featuresLeft, featuresRight;
+  std::tie(featuresLeft, featuresRight) = findFeatures(imageLeft, imageRight);
 
   if (featuresLeft.descriptors.rows == 0 || featuresRight.descriptors.rows == 0 ||
       featuresLeft.keypoints.size() == 0 || featuresRight.keypoints.size() == 0) {
@@ -32,38 +57,313 @@ MatchFinder::Matches MatchFinderCV::findMatches(const std::vector<Image<uint8_t>
 }
 
 FeaturesCV MatchFinderCV::findFeatures(const cv::Mat& img) {
+  return findFeatures(img, getFeatureDetectors(LEFT_EYE));
+}
+
+FeaturesCV MatchFinderCV::findFeatures(const cv::Mat& img,
+                                       const std::vector<cv::Feature2D*>& featureDetectors) {
+  if (featureDetectors.size() > 1) {
+    return findFeaturesInTiles(img, featureDetectors);
+  }
+  auto* featureDetector = featureDetectors.front();
+
   cv::Mat descriptors;
   std::vector<cv::KeyPoint> keypoints;
 
-  auto featureDetector = createFeatureDetector();
   featureDetector->detect(img, keypoints);
-  std::vector<cv::KeyPoint> filteredKeypoints = keepBestKeypointsFromResponse(keypoints, maxNbFeatures_);
+  std::vector<cv::KeyPoint> filteredKeypoints =
+      keepBestKeypointsInGrid(std::move(keypoints), img.size(), maxNbFeatures_, gridCols_,
+                              gridRows_, maxKeypointsPerCell_);
   featureDetector->compute(img, filteredKeypoints, descriptors);
 
   return {descriptors, filteredKeypoints};
 }
 
+FeaturesCV MatchFinderCV::findFeaturesInTiles(
+    const cv::Mat& img,
+    const std::vector<cv::Feature2D*>& featureDetectors) {
+  const size_t nbTiles = featureDetectors.size();
+  const size_t tileBudget = (maxNbFeatures_ + nbTiles - 1) / nbTiles;
+  const cv::Rect imageRect(0, 0, img.cols, img.rows);
+
+  std::vector<FeaturesCV> tileFeatures(nbTiles);
+  ThreadPool::global().parallelFor(0, nbTiles, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const auto tileIdx = static_cast<int>(i);
+      const int col = tileIdx % tileCols_;
+      const int row = tileIdx / tileCols_;
+      const int x0 = col * img.cols / tileCols_;
+      const int x1 = (col + 1) * img.cols / tileCols_;
+      const int y0 = row * img.rows / tileRows_;
+      const int y1 = (row + 1) * img.rows / tileRows_;
+
+      // detection runs on the tile grown by the overlap so the detector and descriptor have
+      // context at inner borders, only keypoints of the tile itself are kept (no duplicates)
+      const cv::Rect tile = cv::Rect(x0 - tileOverlap_, y0 - tileOverlap_,
+                                     x1 - x0 + 2 * tileOverlap_, y1 - y0 + 2 * tileOverlap_) &
+                            imageRect;
+      const cv::Mat tileImage = img(tile);
+      const auto offset = cv::Point2f(static_cast<float>(tile.x), static_cast<float>(tile.y));
+
+      std::vector<cv::KeyPoint> keypoints;
+      featureDetectors[i]->detect(tileImage, keypoints);
+      keypoints.erase(std::remove_if(std::begin(keypoints), std::end(keypoints),
+                                     [&](const cv::KeyPoint& keypoint) {
+                                       auto pt = keypoint.pt + offset;
+                                       return pt.x < x0 || pt.x >= x1 || pt.y < y0 || pt.y >= y1;
+                                     }),
+                      std::end(keypoints));
+      keypoints = keepBestKeypointsInGrid(std::move(keypoints), tileImage.size(), tileBudget, 1, 1);
+
+      featureDetectors[i]->compute(tileImage, keypoints, tileFeatures[i].descriptors);
+      for (auto& keypoint : keypoints) {
+        keypoint.pt += offset;
+      }
+      tileFeatures[i].keypoints = std::move(keypoints);
+    }
+  }, nbThreads_);
+
+  FeaturesCV features;
+  std::vector<cv::Mat> descriptors;
+  for (auto& tile : tileFeatures) {
+    if (tile.keypoints.empty()) {
+      continue;
+    }
+    features.keypoints.insert(std::end(features.keypoints), std::begin(tile.keypoints),
+                              std::end(tile.keypoints));
+    descriptors.push_back(tile.descriptors);
+  }
+  if (!descriptors.empty()) {
+    cv::vconcat(descriptors, features.descriptors);
+  }
+  return features;
+}
+
 FeaturesCV MatchFinderCV::findFeatures(const Image<uint8_t>& img) {
   return findFeatures(s3d::image2cv(img));
 }
 
+std::pair<FeaturesCV, FeaturesCV> MatchFinderCV::findFeatures(const cv::Mat& imageLeft,
+                                                              const cv::Mat& imageRight) {
+  const cv::Mat* images[NB_EYES] = {&imageLeft, &imageRight};
+  std::vector<cv::Feature2D*> detectors[NB_EYES] = {getFeatureDetectors(LEFT_EYE),
+                                                     getFeatureDetectors(RIGHT_EYE)};
+  FeaturesCV features[NB_EYES];
+
+  ThreadPool::global().parallelFor(0, NB_EYES, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      features[i] = findFeatures(*images[i], detectors[i]);
+    }
+  }, nbThreads_);
+
+  return {features[LEFT_EYE], features[RIGHT_EYE]};
+}
+
 MatchFinder::Matches MatchFinderCV::matchFeatures(const FeaturesCV& leftFeatures,
                                                   const FeaturesCV& rightFeatures) {
-  std::vector<std::vector<cv::DMatch>> matches;
-  auto matcher = createDescriptorMatcher();
-  matcher->knnMatch(leftFeatures.descriptors, rightFeatures.descriptors, matches, 2);
+  if (epipolarBand_ > 0.0f) {
+    return matchFeaturesInEpipolarBand(leftFeatures, rightFeatures);
+  }
+  if (isBinary256Descriptors(leftFeatures.descriptors) &&
+      isBinary256Descriptors(rightFeatures.descriptors)) {
+    return matchBinaryFeatures(leftFeatures, rightFeatures);
+  }
+
+  // query descriptors are matched in parallel chunks, each chunk has its own matcher (knnMatch
+  // is not documented as thread safe) trained on the same right descriptors, one chunk per thread
+  // since every matcher builds its own index (e.g. FLANN)
+  constexpr size_t minQueriesPerChunk = 128;
+  const auto nbQueries = static_cast<size_t>(leftFeatures.descriptors.rows);
+  const size_t nbWorkers = nbThreads_ == 0 ? ThreadPool::global().size() + 1 : nbThreads_;
+  const size_t nbChunks =
+      std::min(nbWorkers, std::max<size_t>(1, nbQueries / minQueriesPerChunk));
+  const auto matchers = getDescriptorMatchers(nbChunks);
+
+  std::vector<std::vector<cv::DMatch>> matches(nbQueries);
+  ThreadPool::global().parallelFor(0, nbChunks, [&](size_t chunkBegin, size_t chunkEnd) {
+    for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+      const size_t begin = chunk * nbQueries / nbChunks;
+      const size_t end = (chunk + 1) * nbQueries / nbChunks;
 
-  std::vector<Eigen::Vector2d> pts1, pts2;
+      auto* matcher = matchers[chunk];
+      trainDescriptorMatcher(matcher, rightFeatures.descriptors);
+
+      std::vector<std::vector<cv::DMatch>> chunkMatches;
+      cv::Mat queries =
+          leftFeatures.descriptors.rowRange(static_cast<int>(begin), static_cast<int>(end));
+      matcher->knnMatch(queries, chunkMatches, 2);
+      for (size_t i = 0; i < chunkMatches.size() && begin + i < end; ++i) {
+        for (auto& match : chunkMatches[i]) {
+          match.queryIdx += static_cast<int>(begin);
+        }
+        matches[begin + i] = std::move(chunkMatches[i]);
+      }
+    }
+  }, nbChunks);
+
+  MatchFinder::Matches result(2);
   for (unsigned i = 0; i < matches.size() && i < maxNbFeatures_; i++) {
+    if (matches[i].size() < 2) {
+      continue;
+    }
     if (matches[i][0].distance < 0.6f * matches[i][1].distance) {
       auto& pt1 = leftFeatures.keypoints[matches[i][0].queryIdx].pt;
       auto& pt2 = rightFeatures.keypoints[matches[i][0].trainIdx].pt;
-      pts1.emplace_back(pt1.x, pt1.y);
-      pts2.emplace_back(pt2.x, pt2.y);
+      addMatch(pt1, pt2, matches[i][0].distance, matches[i][1].distance, &result);
+    }
+  }
+
+  return result;
+}
+
+MatchFinder::Matches MatchFinderCV::matchBinaryFeatures(const FeaturesCV& leftFeatures,
+                                                        const FeaturesCV& rightFeatures) {
+  BinaryDescriptorMatcher matcher;
+  matcher.setNumberOfThreads(nbThreads_);
+  auto matches = matcher.knnMatch(leftFeatures.descriptors.ptr<uint8_t>(),
+                                  static_cast<size_t>(leftFeatures.descriptors.rows),
+                                  rightFeatures.descriptors.ptr<uint8_t>(),
+                                  static_cast<size_t>(rightFeatures.descriptors.rows));
+
+  MatchFinder::Matches result(2);
+  for (size_t i = 0; i < matches.size() && i < maxNbFeatures_; i++) {
+    if (matches[i].secondTrainIdx < 0) {
+      continue;
+    }
+    if (matches[i].distance < 0.6f * matches[i].secondDistance) {
+      auto& pt1 = leftFeatures.keypoints[i].pt;
+      auto& pt2 = rightFeatures.keypoints[matches[i].trainIdx].pt;
+      addMatch(pt1, pt2, matches[i].distance, matches[i].secondDistance, &result);
+    }
+  }
+
+  return result;
+}
+
+MatchFinder::Matches MatchFinderCV::matchFeaturesInEpipolarBand(const FeaturesCV& leftFeatures,
+                                                                const FeaturesCV& rightFeatures) {
+  const auto& rightKeypoints = rightFeatures.keypoints;
+  if (rightKeypoints.empty()) {
+    return MatchFinder::Matches{std::vector<Position>{}, std::vector<Position>{}};
+  }
+
+  // right keypoints bucketed by column range (sqrt(N) buckets with a prior, a tilted epipolar line
+  // only spans a few rows over one bucket), sorted by row inside each bucket
+  auto minMaxX = std::minmax_element(std::begin(rightKeypoints),
+                                     std::end(rightKeypoints),
+                                     [](const cv::KeyPoint& a, const cv::KeyPoint& b) {
+                                       return a.pt.x < b.pt.x;
+                                     });
+  const float minX = minMaxX.first->pt.x;
+  const float maxX = minMaxX.second->pt.x;
+  const size_t nbBuckets =
+      hasEpipolarPrior_ && maxX > minX
+          ? std::max<size_t>(1, static_cast<size_t>(std::sqrt(rightKeypoints.size())))
+          : 1;
+  const float bucketWidth = (maxX - minX) / static_cast<float>(nbBuckets);
+  auto bucketOf = [&](int i) {
+    if (nbBuckets == 1) {
+      return size_t{0};
+    }
+    const auto bucket = static_cast<size_t>((rightKeypoints[i].pt.x - minX) / bucketWidth);
+    return std::min(bucket, nbBuckets - 1);
+  };
+
+  std::vector<int> rowOrder(rightKeypoints.size());
+  std::iota(std::begin(rowOrder), std::end(rowOrder), 0);
+  std::sort(std::begin(rowOrder), std::end(rowOrder), [&](int a, int b) {
+    return std::make_pair(bucketOf(a), rightKeypoints[a].pt.y) <
+           std::make_pair(bucketOf(b), rightKeypoints[b].pt.y);
+  });
+  std::vector<float> sortedRows(rowOrder.size());
+  std::vector<size_t> bucketBegin(nbBuckets + 1, 0);
+  std::vector<float> bucketMinX(nbBuckets, std::numeric_limits<float>::max());
+  std::vector<float> bucketMaxX(nbBuckets, std::numeric_limits<float>::lowest());
+  for (size_t i = 0; i < rowOrder.size(); ++i) {
+    const auto& pt = rightKeypoints[rowOrder[i]].pt;
+    const size_t bucket = bucketOf(rowOrder[i]);
+    sortedRows[i] = pt.y;
+    ++bucketBegin[bucket + 1];
+    bucketMinX[bucket] = std::min(bucketMinX[bucket], pt.x);
+    bucketMaxX[bucket] = std::max(bucketMaxX[bucket], pt.x);
+  }
+  std::partial_sum(std::begin(bucketBegin), std::end(bucketBegin), std::begin(bucketBegin));
+
+  const int normType = leftFeatures.descriptors.depth() == CV_8U ? cv::NORM_HAMMING : cv::NORM_L2;
+  const double tolerance = epipolarBand_;
+
+  struct TwoBest {
+    int trainIdx{-1};
+    double first{std::numeric_limits<double>::max()};
+    double second{std::numeric_limits<double>::max()};
+  };
+  const auto nbQueries = static_cast<size_t>(leftFeatures.descriptors.rows);
+  std::vector<TwoBest> twoBest(nbQueries);
+
+  ThreadPool::global().parallelFor(0, nbQueries, [&](size_t begin, size_t end) {
+    for (size_t q = begin; q < end; ++q) {
+      const auto& pt = leftFeatures.keypoints[q].pt;
+      Eigen::Vector3d line = epipolarPrior_ * Eigen::Vector3d(pt.x, pt.y, 1.0);
+      const double lineNorm = std::sqrt(line.x() * line.x() + line.y() * line.y());
+      if (hasEpipolarPrior_ && std::abs(line.y()) < 1e-12) {
+        continue;  // vertical epipolar line, not a near-rectified rig
+      }
+
+      for (size_t bucket = 0; bucket < nbBuckets; ++bucket) {
+        if (bucketBegin[bucket] == bucketBegin[bucket + 1]) {
+          continue;
+        }
+
+        // band of rows to look into, over the columns of this bucket
+        double rowMin = pt.y - tolerance;
+        double rowMax = pt.y + tolerance;
+        if (hasEpipolarPrior_) {
+          double rowAtMinX = -(line.x() * bucketMinX[bucket] + line.z()) / line.y();
+          double rowAtMaxX = -(line.x() * bucketMaxX[bucket] + line.z()) / line.y();
+          rowMin = std::min(rowAtMinX, rowAtMaxX) - tolerance;
+          rowMax = std::max(rowAtMinX, rowAtMaxX) + tolerance;
+        }
+
+        const auto bucketFirst = std::begin(sortedRows) + bucketBegin[bucket];
+        const auto bucketLast = std::begin(sortedRows) + bucketBegin[bucket + 1];
+        auto first = std::lower_bound(bucketFirst, bucketLast, rowMin);
+        auto last = std::upper_bound(first, bucketLast, rowMax);
+        for (auto it = first; it != last; ++it) {
+          const int trainIdx = rowOrder[std::distance(std::begin(sortedRows), it)];
+          const auto& candidate = rightKeypoints[trainIdx].pt;
+          if (hasEpipolarPrior_) {
+            Eigen::Vector3d candidateH(candidate.x, candidate.y, 1.0);
+            if (std::abs(line.dot(candidateH)) > tolerance * lineNorm) {
+              continue;
+            }
+          }
+
+          double distance = cv::norm(leftFeatures.descriptors.row(static_cast<int>(q)),
+                                     rightFeatures.descriptors.row(trainIdx),
+                                     normType);
+          auto& best = twoBest[q];
+          if (distance < best.first) {
+            best.second = best.first;
+            best.first = distance;
+            best.trainIdx = trainIdx;
+          } else if (distance < best.second) {
+            best.second = distance;
+          }
+        }
+      }
+    }
+  }, nbThreads_);
+
+  MatchFinder::Matches result(2);
+  for (size_t i = 0; i < twoBest.size() && i < maxNbFeatures_; i++) {
+    if (twoBest[i].trainIdx >= 0 && twoBest[i].first < 0.6 * twoBest[i].second) {
+      auto& pt1 = leftFeatures.keypoints[i].pt;
+      auto& pt2 = rightKeypoints[twoBest[i].trainIdx].pt;
+      addMatch(pt1, pt2, twoBest[i].first, twoBest[i].second, &result);
     }
   }
 
-  return {pts1, pts2};
+  return result;
 }
 
 double MatchFinderCV::matchesMinDistance(MatchesCV matches) const {
@@ -81,6 +381,12 @@ cv::Ptr<cv::DescriptorMatcher> MatchFinderCV::createDescriptorMatcher() {
   return cv::DescriptorMatcher::create("BruteForce-Hamming(2)");
 }
 
+// static
+bool MatchFinderCV::isBinary256Descriptors(const cv::Mat& descriptors) {
+  return descriptors.type() == CV_8UC1 && descriptors.isContinuous() &&
+         static_cast<size_t>(descriptors.cols) == BinaryDescriptorMatcher::DESCRIPTOR_SIZE;
+}
+
 // static
 double MatchFinderCV::computeThreshold(int imageWidth, int imageHeight) {
   double W = imageWidth;
@@ -89,15 +395,176 @@ double MatchFinderCV::computeThreshold(int imageWidth, int imageHeight) {
 }
 
 std::vector<cv::KeyPoint> MatchFinderCV::keepBestKeypointsFromResponse(const std::vector<cv::KeyPoint> &keypoints, size_t numberToKeep) {
-  // get max nb features sorted by response
-  std::vector<cv::KeyPoint> filteredKeypoints = keypoints;
-  std::sort(std::begin(filteredKeypoints), std::end(filteredKeypoints), [](cv::KeyPoint a, cv::KeyPoint b) { return a.response > b.response; });
-  filteredKeypoints.resize(std::min(numberToKeep, filteredKeypoints.size()));
-  return filteredKeypoints;
+  // get max nb features with highest response (single cell)
+  return keepBestKeypointsInGrid(keypoints, cv::Size(), numberToKeep, 1, 1);
+}
+
+// static
+std::vector<cv::KeyPoint> MatchFinderCV::keepBestKeypointsInGrid(
+    std::vector<cv::KeyPoint> keypoints,
+    cv::Size imageSize,
+    size_t numberToKeep,
+    int nbCols,
+    int nbRows,
+    size_t maxPerCell) {
+  auto higherResponse = [](const cv::KeyPoint& a, const cv::KeyPoint& b) {
+    return a.response > b.response;
+  };
+  auto keepBest = [&higherResponse](std::vector<cv::KeyPoint>* points, size_t n) {
+    if (n < points->size()) {
+      std::nth_element(points->begin(), points->begin() + n, points->end(), higherResponse);
+      points->resize(n);
+    }
+  };
+
+  nbCols = std::max(nbCols, 1);
+  nbRows = std::max(nbRows, 1);
+  const size_t nbCells = static_cast<size_t>(nbCols * nbRows);
+  if (nbCells == 1 && maxPerCell == 0) {
+    keepBest(&keypoints, numberToKeep);
+    return keypoints;
+  }
+
+  // bucket keypoints by cell
+  std::vector<std::vector<cv::KeyPoint>> cells(nbCells);
+  const float cellWidth = std::max(imageSize.width, 1) / static_cast<float>(nbCols);
+  const float cellHeight = std::max(imageSize.height, 1) / static_cast<float>(nbRows);
+  for (const auto& keypoint : keypoints) {
+    int col = std::min(std::max(static_cast<int>(keypoint.pt.x / cellWidth), 0), nbCols - 1);
+    int row = std::min(std::max(static_cast<int>(keypoint.pt.y / cellHeight), 0), nbRows - 1);
+    cells[static_cast<size_t>(row * nbCols + col)].push_back(keypoint);
+  }
+
+  // top-k per cell, the remaining budget is given to the best discarded keypoints
+  const size_t evenShare = (numberToKeep + nbCells - 1) / nbCells;
+  const size_t perCell = maxPerCell > 0 ? std::min(maxPerCell, numberToKeep) : evenShare;
+
+  std::vector<cv::KeyPoint> selected;
+  std::vector<cv::KeyPoint> leftovers;
+  selected.reserve(std::min(numberToKeep, keypoints.size()));
+  for (auto& cell : cells) {
+    if (cell.size() > perCell) {
+      std::nth_element(cell.begin(), cell.begin() + perCell, cell.end(), higherResponse);
+      if (maxPerCell == 0) {
+        leftovers.insert(leftovers.end(), cell.begin() + perCell, cell.end());
+      }
+      cell.resize(perCell);
+    }
+    selected.insert(selected.end(), cell.begin(), cell.end());
+  }
+
+  if (selected.size() > numberToKeep) {
+    keepBest(&selected, numberToKeep);
+  } else {
+    keepBest(&leftovers, numberToKeep - selected.size());
+    selected.insert(selected.end(), leftovers.begin(), leftovers.end());
+  }
+  return selected;
 }
 
 void MatchFinderCV::setMaxNumberOfFeatures(int maxNumberOfFeatures) {
-  maxNbFeatures_ = static_cast<size_t>(maxNumberOfFeatures);
+  auto maxNbFeatures = static_cast<size_t>(maxNumberOfFeatures);
+  if (maxNbFeatures != maxNbFeatures_) {
+    ++settingsGeneration_;
+    maxNbFeatures_ = maxNbFeatures;
+    resetInstances();
+  }
+}
+
+void MatchFinderCV::setKeypointGrid(int nbCols, int nbRows, int maxPerCell) {
+  ++settingsGeneration_;
+  gridCols_ = std::max(nbCols, 1);
+  gridRows_ = std::max(nbRows, 1);
+  maxKeypointsPerCell_ = static_cast<size_t>(std::max(maxPerCell, 0));
+}
+
+void MatchFinderCV::setDetectionTiles(int nbCols, int nbRows, int overlap) {
+  ++settingsGeneration_;
+  nbCols = std::max(nbCols, 1);
+  nbRows = std::max(nbRows, 1);
+  if (nbCols != tileCols_ || nbRows != tileRows_) {
+    tileCols_ = nbCols;
+    tileRows_ = nbRows;
+    resetInstances();
+  }
+  tileOverlap_ = std::max(overlap, 0);
+}
+
+void MatchFinderCV::setNumberOfThreads(int nbThreads) {
+  nbThreads_ = static_cast<size_t>(std::max(nbThreads, 0));
+}
+
+void MatchFinderCV::setEpipolarBand(float rowTolerance) {
+  ++settingsGeneration_;
+  epipolarBand_ = rowTolerance;
+}
+
+uint64_t MatchFinderCV::getSettingsGeneration() const {
+  return settingsGeneration_;
+}
+
+void MatchFinderCV::setEpipolarPrior(const Eigen::Matrix3d& F) {
+  epipolarPrior_ = F;
+  hasEpipolarPrior_ = true;
+}
+
+void MatchFinderCV::clearEpipolarPrior() {
+  hasEpipolarPrior_ = false;
+}
+
+void MatchFinderCV::resetInstances() {
+  for (auto& featureDetectors : featureDetectors_) {
+    featureDetectors.clear();
+  }
+  descriptorMatchers_.clear();
+}
+
+std::vector<cv::Feature2D*> MatchFinderCV::getFeatureDetectors(size_t eye) {
+  assert(eye < NB_EYES);
+  auto& featureDetectors = featureDetectors_[eye];
+  const auto nbTiles = static_cast<size_t>(tileCols_ * tileRows_);
+  while (featureDetectors.size() < nbTiles) {
+    featureDetectors.push_back(createFeatureDetector());
+
+    // avoid detecting the whole budget in every tile
+    auto* orb = dynamic_cast<cv::ORB*>(featureDetectors.back().get());
+    if (orb != nullptr && nbTiles > 1) {
+      orb->setMaxFeatures(static_cast<int>((maxNbFeatures_ + nbTiles - 1) / nbTiles));
+    }
+  }
+
+  std::vector<cv::Feature2D*> detectors;
+  for (auto& featureDetector : featureDetectors) {
+    detectors.push_back(featureDetector.get());
+  }
+  return detectors;
+}
+
+// static
+void MatchFinderCV::trainDescriptorMatcher(cv::DescriptorMatcher* matcher,
+                                           const cv::Mat& descriptors) {
+  // the matcher shares the buffer of its train descriptors, the same buffer means the same
+  // descriptors (it cannot be freed and reused by other descriptors while the matcher holds it)
+  const auto& trained = matcher->getTrainDescriptors();
+  if (trained.size() == 1 && trained[0].data == descriptors.data &&
+      trained[0].size() == descriptors.size()) {
+    return;
+  }
+  matcher->clear();
+  matcher->add(std::vector<cv::Mat>{descriptors});
+  matcher->train();
+}
+
+std::vector<cv::DescriptorMatcher*> MatchFinderCV::getDescriptorMatchers(size_t nbMatchers) {
+  while (descriptorMatchers_.size() < nbMatchers) {
+    descriptorMatchers_.push_back(createDescriptorMatcher());
+  }
+
+  std::vector<cv::DescriptorMatcher*> matchers;
+  for (size_t i = 0; i < nbMatchers; ++i) {
+    matchers.push_back(descriptorMatchers_[i].get());
+  }
+  return matchers;
 }
 
 void MatchFinderCVViz::onFeaturesFound(const cv::Mat& imgLeft,
@@ -1,17 +1,56 @@
 #include "s3d/cv/image_operation/compute_alignment.h"
 
 #include "s3d/cv/disparity/disparity_analyzer_stan.h"
+#include "s3d/multiview/stan_results.h"
+
+#include "s3d/utilities/hash.h"
 
 #include <opencv2/core/mat.hpp>
 
 namespace s3d {
 namespace image_operation {
 
+// the results are everything the analysis of a pair produces (features, matches and model are
+// not reused separately: any setting change invalidates them all)
+struct ComputeAlignment::Cache {
+  uint64_t key{0};
+  bool success{false};
+  DisparityAnalyzerSTAN::Results results{};
+};
+
 ComputeAlignment::ComputeAlignment(gsl::not_null<s3d::DisparityAnalyzerSTAN*> disparityAnalyzer)
   : disparityAnalyzer_{disparityAnalyzer} {}
 
+ComputeAlignment::~ComputeAlignment() = default;
+
+void ComputeAlignment::setCacheEnabled(bool enabled) {
+  cacheEnabled_ = enabled;
+  clearCache();
+}
+
+void ComputeAlignment::clearCache() {
+  cache_.reset();
+}
+
 bool ComputeAlignment::applyOnImage(cv::Mat* leftImage, cv::Mat* rightImage, StanResults* results) {
-  bool enoughFeaturePointsFound = disparityAnalyzer_->analyze(*leftImage, *rightImage);
+  bool enoughFeaturePointsFound;
+
+  const uint64_t key = cacheEnabled_ ? computeCacheKey(*leftImage, *rightImage) : 0;
+  if (cacheEnabled_ && cache_ != nullptr && key == cache_->key) {
+    // skip detection and estimation, restore analyzer outputs in case it was used in between
+    disparityAnalyzer_->results = cache_->results;
+    enoughFeaturePointsFound = cache_->success;
+  } else {
+    enoughFeaturePointsFound = disparityAnalyzer_->analyze(*leftImage, *rightImage);
+    if (cacheEnabled_) {
+      if (cache_ == nullptr) {
+        cache_ = std::make_unique<Cache>();
+      }
+      cache_->key = key;
+      cache_->success = enoughFeaturePointsFound;
+      cache_->results = disparityAnalyzer_->results;
+    }
+  }
 
   // output results
   results->alignment = disparityAnalyzer_->results.stan.alignment;
@@ -21,6 +60,21 @@ bool ComputeAlignment::applyOnImage(cv::Mat* leftImage, cv::Mat* rightImage, Sta
   return enoughFeaturePointsFound && disparityRangeWideEnough();
 }
 
+uint64_t ComputeAlignment::computeCacheKey(const cv::Mat& leftImage,
+                                           const cv::Mat& rightImage) const {
+  uint64_t key = disparityAnalyzer_->getSettingsGeneration();
+  for (const cv::Mat* image : {&leftImage, &rightImage}) {
+    key = hash_combine(key, static_cast<uint64_t>(image->type()));
+    key = hash_combine(key, static_cast<uint64_t>(image->cols));
+    key = hash_combine(key, static_cast<uint64_t>(image->rows));
+    const size_t rowSize = image->cols * image->elemSize();
+    for (int row = 0; row < image->rows; ++row) {
+      key = hash_bytes(image->ptr<uint8_t>(row), rowSize, key);
+    }
+  }
+  return key;
+}
+
 bool ComputeAlignment::disparityRangeWideEnough() {
   return (disparityAnalyzer_->results.maxDisparityPercent - disparityAnalyzer_->results.minDisparityPercent) > minDisparityRange_;
 }
@@ -2,6 +2,11 @@
 
 #include "s3d/cv/disparity/disparity_analyzer_stan.h"
 
+#include <opencv2/imgproc.hpp>
+
+#include <cmath>
+#include <utility>
+
 using s3d::DisparityAnalyzerSTAN;
 using s3d::StanAlignment;
 
@@ -26,3 +31,69 @@ TEST(disparity_analyzer_stan_results, results_to_alignment) {
 
   EXPECT_TRUE(alignmentEqual(alignment, resultsAlignment));
 }
+
+TEST(disparity_analyzer_stan_correspondences, inliers_are_kept_in_place) {
+  s3d::MatchFinder::Matches matches{{{10.0, 20.0}, {30.0, 40.0}, {50.0, 60.0}},
+                                    {{12.0, 20.0}, {25.0, 40.0}, {51.0, 60.0}}};
+  const Eigen::Vector3d center(40.0, 30.0, 0.0);
+
+  DisparityAnalyzerSTAN::Correspondences correspondences;
+  correspondences.assign(matches, center);
+  EXPECT_EQ(correspondences.view().sample1(1), Eigen::Vector3d(-10.0, 10.0, 1.0));
+
+  s3d::robust::InlierMask inliers(3);
+  inliers.fill({0.0, 1.0, 0.0}, 0.5);
+  correspondences.keep(inliers);
+  correspondences.computeDisparities();
+
+  ASSERT_EQ(correspondences.size(), 2U);
+  EXPECT_EQ(correspondences.view().sample2(1), Eigen::Vector3d(11.0, 30.0, 1.0));
+  EXPECT_EQ(correspondences.disparities, std::vector<double>({2.0, 1.0}));
+
+  // analysis at half scale, features are reported in full resolution
+  DisparityAnalyzerSTAN::Results results;
+  results.updateParameters(-10.0, 10.0, 1.0f, StanAlignment{});
+  results.updatePoints(correspondences, center, 1.0f, 2.0f);
+  ASSERT_EQ(results.stan.featuresLeft.size(), 2U);
+  EXPECT_EQ(results.stan.featuresLeft[1], Eigen::Vector2f(100.0f, 120.0f));
+  EXPECT_EQ(results.stan.featuresRight[0], Eigen::Vector2f(24.0f, 40.0f));
+}
+
+// coarse texture (survives half scale analysis), the right view is moved 12 pixels to the left and
+// 4 pixels down
+std::pair<cv::Mat, cv::Mat> shiftedStereoPair() {
+  cv::Mat texture(120, 160, CV_8UC1);
+  cv::theRNG().state = 0;
+  cv::randu(texture, cv::Scalar::all(0), cv::Scalar::all(255));
+
+  cv::Mat left;
+  cv::resize(texture, left, cv::Size(640, 480), 0.0, 0.0, cv::INTER_CUBIC);
+  cv::Mat right;
+  const cv::Mat shift = (cv::Mat_<double>(2, 3) << 1.0, 0.0, -12.0, 0.0, 1.0, 4.0);
+  cv::warpAffine(left, right, shift, left.size(), cv::INTER_LINEAR, cv::BORDER_REFLECT);
+  return {left, right};
+}
+
+TEST(disparity_analyzer_stan, results_do_not_depend_on_analysis_scale) {
+  const auto images = shiftedStereoPair();
+
+  DisparityAnalyzerSTAN full, half;
+  half.setAnalysisScale(0.5f);
+  ASSERT_TRUE(full.analyze(images.first, images.second));
+  ASSERT_TRUE(half.analyze(images.first, images.second));
+
+  // tilt offset in full resolution pixels
+  const auto& fullAlignment = full.results.stan.alignment;
+  const auto& halfAlignment = half.results.stan.alignment;
+  EXPECT_NEAR(std::abs(fullAlignment.f_a_x), 4.0, 0.5);
+  EXPECT_NEAR(halfAlignment.f_a_x, fullAlignment.f_a_x, 0.5);
+  EXPECT_NEAR(halfAlignment.ch_y, fullAlignment.ch_y, 1e-3);
+  EXPECT_NEAR(halfAlignment.a_y_f, fullAlignment.a_y_f, 1e-4);
+
+  EXPECT_NEAR(half.results.minDisparityPercent, full.results.minDisparityPercent, 0.3);
+  EXPECT_NEAR(half.results.maxDisparityPercent, full.results.maxDisparityPercent, 0.3);
+  ASSERT_FALSE(half.getFeaturePointsLeft().empty());
+  for (const auto& point : half.getFeaturePointsLeft()) {
+    EXPECT_TRUE(0.0f <= point.x() && point.x() < 640.0f && 0.0f <= point.y() && point.y() < 480.0f);
+  }
+}
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include "s3d/cv/features/feature_tracker_cv.h"
+
+#include <opencv2/imgproc.hpp>
+
+using s3d::FeatureTrackerCV;
+using s3d::MatchFinder;
+
+cv::Mat texturedImage() {
+  cv::Mat image(240, 320, CV_8U);
+  cv::RNG rng(0);
+  rng.fill(image, cv::RNG::UNIFORM, 0, 255);
+  cv::GaussianBlur(image, image, cv::Size(5, 5), 1.5);
+  return image;
+}
+
+cv::Mat translated(const cv::Mat& image, float dx, float dy) {
+  cv::Mat shifted;
+  cv::Mat T = (cv::Mat_<double>(2, 3) << 1, 0, dx, 0, 1, dy);
+  cv::warpAffine(image, shifted, T, image.size());
+  return shifted;
+}
+
+MatchFinder::Matches gridMatches() {
+  MatchFinder::Matches matches(2);
+  for (int y = 60; y < 200; y += 20) {
+    for (int x = 60; x < 260; x += 20) {
+      matches[0].emplace_back(x, y);
+      matches[1].emplace_back(x - 5, y);
+    }
+  }
+  return matches;
+}
+
+TEST(feature_tracker_cv, no_reference_tracks_nothing) {
+  FeatureTrackerCV tracker;
+  cv::Mat image = texturedImage();
+  EXPECT_FALSE(tracker.hasReference());
+  EXPECT_TRUE(tracker.track(image, image)[0].empty());
+}
+
+TEST(feature_tracker_cv, follows_translation) {
+  cv::Mat image = texturedImage();
+  auto matches = gridMatches();
+
+  FeatureTrackerCV tracker;
+  tracker.setReference(image, image, matches);
+
+  auto tracked = tracker.track(translated(image, 2.0f, 1.0f), translated(image, 2.0f, 1.0f));
+  ASSERT_EQ(tracked[0].size(), matches[0].size());
+  EXPECT_FALSE(tracker.sceneCutDetected());
+  for (size_t i = 0; i < tracked[0].size(); ++i) {
+    EXPECT_NEAR(tracked[0][i].x(), matches[0][i].x() + 2.0, 0.2);
+    EXPECT_NEAR(tracked[0][i].y(), matches[0][i].y() + 1.0, 0.2);
+    EXPECT_NEAR(tracked[1][i].x(), matches[1][i].x() + 2.0, 0.2);
+  }
+}
+
+TEST(feature_tracker_cv, consecutive_tracks_start_from_last_positions) {
+  cv::Mat image = texturedImage();
+  auto matches = gridMatches();
+
+  FeatureTrackerCV tracker;
+  tracker.setReference(image, image, matches);
+
+  // no new reference in between, the second track continues from the first one
+  tracker.track(translated(image, 2.0f, 1.0f), translated(image, 2.0f, 1.0f));
+  auto tracked = tracker.track(translated(image, 4.0f, 2.0f), translated(image, 4.0f, 2.0f));
+  ASSERT_EQ(tracked[0].size(), matches[0].size());
+  for (size_t i = 0; i < tracked[0].size(); ++i) {
+    EXPECT_NEAR(tracked[0][i].x(), matches[0][i].x() + 4.0, 0.3);
+    EXPECT_NEAR(tracked[0][i].y(), matches[0][i].y() + 2.0, 0.3);
+    EXPECT_NEAR(tracked[1][i].x(), matches[1][i].x() + 4.0, 0.3);
+  }
+}
+
+TEST(feature_tracker_cv, reference_points_reuse_last_tracked_pyramids) {
+  cv::Mat image = texturedImage();
+  auto matches = gridMatches();
+
+  FeatureTrackerCV tracker;
+  tracker.setReference(image, image, matches);
+  tracker.track(translated(image, 2.0f, 1.0f), translated(image, 2.0f, 1.0f));
+
+  // new points in the last tracked frame, without rebuilding its pyramids
+  MatchFinder::Matches shifted(2);
+  for (size_t i = 0; i < matches[0].size(); ++i) {
+    shifted[0].emplace_back(matches[0][i].x() + 2.0, matches[0][i].y() + 1.0);
+    shifted[1].emplace_back(matches[1][i].x() + 2.0, matches[1][i].y() + 1.0);
+  }
+  tracker.setReferencePoints(shifted);
+
+  auto tracked = tracker.track(translated(image, 5.0f, 1.0f), translated(image, 5.0f, 1.0f));
+  ASSERT_EQ(tracked[0].size(), shifted[0].size());
+  for (size_t i = 0; i < tracked[0].size(); ++i) {
+    EXPECT_NEAR(tracked[0][i].x(), shifted[0][i].x() + 3.0, 0.3);
+    EXPECT_NEAR(tracked[1][i].y(), shifted[1][i].y(), 0.3);
+  }
+}
+
+TEST(feature_tracker_cv, reset_removes_reference) {
+  cv::Mat image = texturedImage();
+  FeatureTrackerCV tracker;
+  tracker.setReference(image, image, gridMatches());
+  EXPECT_TRUE(tracker.hasReference());
+  tracker.reset();
+  EXPECT_FALSE(tracker.hasReference());
+}
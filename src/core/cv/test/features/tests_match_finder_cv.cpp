@@ -2,8 +2,11 @@
 
 #include "s3d/cv/features/match_finder_cv.h"
 
+#include "s3d/concurrency/thread_pool.h"
+
 #include <opencv/cv.hpp>
 
+#include <algorithm>
 #include <vector>
 
 using s3d::MatchFinderCV;
@@ -141,3 +144,305 @@ TEST(match_finder_cv, cv_instance_creation_return_valid_objects) {
   EXPECT_NE(m.createFeatureDetector(), nullptr);
   EXPECT_NE(m.createDescriptorMatcher(), nullptr);
 }
+
+class CountingMatchFinderCV : public FakeMatchFinderCV {
+ public:
+  cv::Ptr<cv::Feature2D> createFeatureDetector() override {
+    nbDetectorsCreated++;
+    return cv::Ptr<cv::Feature2D>(new FakeFeatureDetector);
+  }
+
+  int nbDetectorsCreated{0};
+};
+
+TEST(match_finder_cv, feature_detector_is_reused_between_images) {
+  CountingMatchFinderCV matchFinder;
+  matchFinder.findFeatures(cv::Mat{});
+  matchFinder.findFeatures(cv::Mat{});
+  EXPECT_EQ(matchFinder.nbDetectorsCreated, 1);
+}
+
+TEST(match_finder_cv, feature_detector_recreated_when_max_nb_features_changes) {
+  CountingMatchFinderCV matchFinder;
+  matchFinder.findFeatures(cv::Mat{});
+  matchFinder.setMaxNumberOfFeatures(3000);  // unchanged (default)
+  matchFinder.findFeatures(cv::Mat{});
+  EXPECT_EQ(matchFinder.nbDetectorsCreated, 1);
+
+  matchFinder.setMaxNumberOfFeatures(100);
+  matchFinder.findFeatures(cv::Mat{});
+  EXPECT_EQ(matchFinder.nbDetectorsCreated, 2);
+}
+
+TEST(match_finder_cv, one_feature_detector_per_detection_tile) {
+  CountingMatchFinderCV matchFinder;
+  matchFinder.setDetectionTiles(2, 2);
+  matchFinder.findFeatures(cv::Mat(100, 100, CV_8U, cv::Scalar(0)));
+  matchFinder.findFeatures(cv::Mat(100, 100, CV_8U, cv::Scalar(0)));
+  EXPECT_EQ(matchFinder.nbDetectorsCreated, 4);
+}
+
+TEST(match_finder_cv, tiled_detection_keeps_each_keypoint_once) {
+  cv::Mat image(240, 320, CV_8U);
+  cv::randu(image, 0, 256);
+  cv::GaussianBlur(image, image, cv::Size(3, 3), 0);
+
+  MatchFinderCV matchFinder;
+  matchFinder.setMaxNumberOfFeatures(500);
+  matchFinder.setDetectionTiles(3, 2);
+  auto features = matchFinder.findFeatures(image);
+
+  ASSERT_FALSE(features.keypoints.empty());
+  EXPECT_LE(features.keypoints.size(), 500u);
+  EXPECT_EQ(static_cast<size_t>(features.descriptors.rows), features.keypoints.size());
+
+  auto samePosition = [](const cv::KeyPoint& a, const cv::KeyPoint& b) {
+    return a.pt == b.pt && a.octave == b.octave;
+  };
+  for (size_t i = 0; i < features.keypoints.size(); ++i) {
+    const auto& pt = features.keypoints[i].pt;
+    EXPECT_TRUE(pt.x >= 0 && pt.x < image.cols && pt.y >= 0 && pt.y < image.rows);
+    EXPECT_TRUE(std::none_of(features.keypoints.begin() + i + 1, features.keypoints.end(),
+                             [&](const cv::KeyPoint& other) {
+                               return samePosition(features.keypoints[i], other);
+                             }));
+  }
+}
+
+// knnMatch also calls train(), only the calls indexing newly added descriptors are counted
+class CountingTrainMatcher : public cv::BFMatcher {
+ public:
+  explicit CountingTrainMatcher(int* nbTrainings) : nbTrainings_{nbTrainings} {}
+
+  void add(cv::InputArrayOfArrays descriptors) override {
+    cv::BFMatcher::add(descriptors);
+    untrained_ = true;
+  }
+
+  void train() override {
+    if (untrained_) {
+      ++*nbTrainings_;
+      untrained_ = false;
+    }
+    cv::BFMatcher::train();
+  }
+
+ private:
+  int* nbTrainings_;
+  bool untrained_{false};
+};
+
+class CountingMatcherMatchFinderCV : public MatchFinderCV {
+ public:
+  cv::Ptr<cv::DescriptorMatcher> createDescriptorMatcher() override {
+    nbMatchersCreated++;
+    return cv::Ptr<cv::DescriptorMatcher>(new CountingTrainMatcher(&nbTrainings));
+  }
+
+  int nbMatchersCreated{0};
+  int nbTrainings{0};
+};
+
+MatchFinderCV::Features randomFloatFeatures(int nbFeatures) {
+  MatchFinderCV::Features features;
+  features.descriptors = cv::Mat(nbFeatures, 8, CV_32F);
+  cv::randu(features.descriptors, 0.0f, 1.0f);
+  for (int i = 0; i < features.descriptors.rows; ++i) {
+    features.keypoints.emplace_back(cv::Point2f(static_cast<float>(i), 0.0f), 1.0f);
+  }
+  return features;
+}
+
+TEST(match_finder_cv, one_descriptor_matcher_per_query_chunk) {
+  const auto features = randomFloatFeatures(512);
+
+  CountingMatcherMatchFinderCV matchFinder;
+  matchFinder.setNumberOfThreads(2);
+  auto matches = matchFinder.matchFeatures(features, features);
+  matchFinder.matchFeatures(features, features);
+  EXPECT_EQ(matchFinder.nbMatchersCreated, 2);
+
+  // every query is its own best match, whichever chunk it was in
+  ASSERT_EQ(matches[0].size(), features.keypoints.size());
+  for (size_t i = 0; i < matches[0].size(); ++i) {
+    EXPECT_EQ(matches[0][i], matches[1][i]);
+  }
+}
+
+TEST(match_finder_cv, descriptor_matchers_are_trained_once_per_frame) {
+  const auto left = randomFloatFeatures(3000);
+
+  // at most one matcher per thread, whatever the number of queries
+  CountingMatcherMatchFinderCV matchFinder;
+  constexpr int nbFrames = 3;
+  for (int frame = 0; frame < nbFrames; ++frame) {
+    const auto right = randomFloatFeatures(3000);
+    matchFinder.matchFeatures(left, right);
+  }
+  const int nbMaxMatchers = static_cast<int>(s3d::ThreadPool::global().size() + 1);
+  EXPECT_LE(matchFinder.nbMatchersCreated, nbMaxMatchers);
+  EXPECT_EQ(matchFinder.nbTrainings, nbFrames * matchFinder.nbMatchersCreated);
+
+  // unchanged right descriptors are not indexed again
+  const auto right = randomFloatFeatures(3000);
+  matchFinder.matchFeatures(left, right);
+  const int nbTrainings = matchFinder.nbTrainings;
+  matchFinder.matchFeatures(left, right);
+  EXPECT_EQ(matchFinder.nbTrainings, nbTrainings);
+}
+
+MatchFinderCV::Features bandTestFeatures(std::vector<cv::Point2f> positions,
+                                         std::vector<uchar> descriptorValues) {
+  MatchFinderCV::Features features;
+  features.descriptors = cv::Mat(static_cast<int>(positions.size()), 32, CV_8U);
+  for (size_t i = 0; i < positions.size(); ++i) {
+    features.keypoints.emplace_back(positions[i], 1.0f);
+    features.descriptors.row(static_cast<int>(i)).setTo(descriptorValues[i]);
+  }
+  return features;
+}
+
+TEST(match_finder_cv, epipolar_band_ignores_candidates_on_other_rows) {
+  auto left = bandTestFeatures({{10.0f, 10.0f}}, {0x00});
+
+  // identical descriptor far from the row, close descriptor on the same row
+  auto right = bandTestFeatures({{12.0f, 100.0f}, {12.0f, 10.0f}, {12.0f, 11.0f}},
+                                {0x00, 0x01, 0xFF});
+
+  MatchFinderCV matchFinder;
+  matchFinder.setEpipolarBand(5.0f);
+  auto matches = matchFinder.matchFeatures(left, right);
+
+  ASSERT_EQ(matches[1].size(), 1u);
+  expectSamePoint(matches[1][0], right.keypoints[1].pt);
+}
+
+TEST(match_finder_cv, epipolar_band_follows_prior_epipolar_line) {
+  auto left = bandTestFeatures({{10.0f, 10.0f}}, {0x00});
+  auto right = bandTestFeatures({{12.0f, 10.0f}, {12.0f, 30.0f}, {14.0f, 31.0f}},
+                                {0x00, 0x01, 0xFF});
+
+  // epipolar lines are shifted 20 pixels down in the right image: y' = y + 20
+  Eigen::Matrix3d F;
+  F << 0, 0, 0,  //
+      0, 0, -1,  //
+      0, 1, 20;
+
+  MatchFinderCV matchFinder;
+  matchFinder.setEpipolarBand(5.0f);
+  matchFinder.setEpipolarPrior(F);
+  auto matches = matchFinder.matchFeatures(left, right);
+
+  ASSERT_EQ(matches[1].size(), 1u);
+  expectSamePoint(matches[1][0], right.keypoints[1].pt);
+}
+
+TEST(match_finder_cv, epipolar_band_follows_tilted_epipolar_line) {
+  auto left = bandTestFeatures({{10.0f, 10.0f}}, {0x00});
+
+  // grid of distractors, identical descriptor off the line, best and second best on the line
+  std::vector<cv::Point2f> positions{{100.0f, 80.0f}, {100.0f, 60.0f}, {40.0f, 30.0f}};
+  std::vector<uchar> values{0x00, 0x00, 0x01};
+  for (int y = 0; y < 200; y += 25) {
+    for (int x = 5; x < 200; x += 25) {
+      positions.emplace_back(static_cast<float>(x), static_cast<float>(y));
+      values.push_back(0xFF);
+    }
+  }
+  auto right = bandTestFeatures(positions, values);
+
+  // epipolar lines are tilted in the right image: y' = y + 0.5 * x'
+  Eigen::Matrix3d F;
+  F << 0, 0, -0.5,  //
+      0, 0, 1,      //
+      0, -1, 0;
+
+  MatchFinderCV matchFinder;
+  matchFinder.setEpipolarBand(2.0f);
+  matchFinder.setEpipolarPrior(F);
+  auto matches = matchFinder.matchFeatures(left, right);
+
+  ASSERT_EQ(matches[1].size(), 1u);
+  expectSamePoint(matches[1][0], right.keypoints[1].pt);
+}
+
+TEST(match_finder_cv, matches_carry_ratio_test_margin_as_quality) {
+  // hamming distances: q0 -> {0, 32, 256}, q1 -> {64, 32, 192}
+  auto left = bandTestFeatures({{10.0f, 10.0f}, {20.0f, 10.0f}}, {0x00, 0x03});
+  auto right = bandTestFeatures({{12.0f, 10.0f}, {22.0f, 10.0f}, {32.0f, 10.0f}},
+                                {0x00, 0x01, 0xFF});
+
+  MatchFinderCV matchFinder;
+  auto matches = matchFinder.matchFeatures(left, right);
+
+  ASSERT_EQ(matches.qualities.size(), 2u);
+  EXPECT_DOUBLE_EQ(matches.qualities[0], 1.0);
+  EXPECT_DOUBLE_EQ(matches.qualities[1], 0.5);
+}
+
+TEST(match_finder_cv, keep_best_keypoints_from_response_keeps_highest) {
+  std::vector<cv::KeyPoint> keypoints;
+  for (int i = 0; i < 10; ++i) {
+    keypoints.emplace_back(cv::Point2f(i, 0), 1.0f, -1, static_cast<float>(i));
+  }
+
+  MatchFinderCV matchFinder;
+  auto best = matchFinder.keepBestKeypointsFromResponse(keypoints, 3);
+
+  ASSERT_EQ(best.size(), 3u);
+  for (const auto& keypoint : best) {
+    EXPECT_GE(keypoint.response, 7.0f);
+  }
+}
+
+TEST(match_finder_cv, keep_best_keypoints_in_grid_spreads_over_cells) {
+  // strong keypoints clustered in the left half, weak ones in the right half
+  std::vector<cv::KeyPoint> keypoints;
+  for (int i = 0; i < 10; ++i) {
+    keypoints.emplace_back(cv::Point2f(10, i), 1.0f, -1, 100.0f + i);
+    keypoints.emplace_back(cv::Point2f(90, i), 1.0f, -1, static_cast<float>(i));
+  }
+
+  auto best = MatchFinderCV::keepBestKeypointsInGrid(keypoints, {100, 10}, 4, 2, 1);
+
+  ASSERT_EQ(best.size(), 4u);
+  auto nbRight = std::count_if(best.begin(), best.end(),
+                               [](const cv::KeyPoint& k) { return k.pt.x > 50; });
+  EXPECT_EQ(nbRight, 2);
+}
+
+TEST(match_finder_cv, keep_best_keypoints_in_grid_fills_budget_from_other_cells) {
+  std::vector<cv::KeyPoint> keypoints;
+  for (int i = 0; i < 10; ++i) {
+    keypoints.emplace_back(cv::Point2f(10, i), 1.0f, -1, static_cast<float>(i));
+  }
+  keypoints.emplace_back(cv::Point2f(90, 0), 1.0f, -1, 0.0f);
+
+  auto best = MatchFinderCV::keepBestKeypointsInGrid(keypoints, {100, 10}, 6, 2, 1);
+
+  EXPECT_EQ(best.size(), 6u);
+}
+
+TEST(match_finder_cv, keep_best_keypoints_in_grid_respects_per_cell_cap) {
+  std::vector<cv::KeyPoint> keypoints;
+  for (int i = 0; i < 10; ++i) {
+    keypoints.emplace_back(cv::Point2f(10, i), 1.0f, -1, static_cast<float>(i));
+  }
+  keypoints.emplace_back(cv::Point2f(90, 0), 1.0f, -1, 0.0f);
+
+  auto best = MatchFinderCV::keepBestKeypointsInGrid(keypoints, {100, 10}, 6, 2, 1, 2);
+
+  EXPECT_EQ(best.size(), 3u);
+}
+
+TEST(match_finder_cv, settings_generation_ignores_epipolar_prior) {
+  MatchFinderCV matchFinder;
+  const uint64_t initial = matchFinder.getSettingsGeneration();
+
+  matchFinder.setEpipolarPrior(Eigen::Matrix3d::Identity());
+  matchFinder.clearEpipolarPrior();
+  EXPECT_EQ(matchFinder.getSettingsGeneration(), initial);
+
+  matchFinder.setEpipolarBand(3.0f);
+  EXPECT_NE(matchFinder.getSettingsGeneration(), initial);
+}
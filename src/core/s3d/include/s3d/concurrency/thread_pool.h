@@ -0,0 +1,70 @@
+#ifndef S3D_CONCURRENCY_THREAD_POOL_H
+#define S3D_CONCURRENCY_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace s3d {
+
+/**
+ * Fixed number of worker threads consuming a FIFO task queue.
+ *
+ * parallelFor makes the calling thread take part in the work, so it is safe
+ * to call it from a task already running on the pool (no nested deadlock).
+ */
+class ThreadPool {
+ public:
+  using Range = std::function<void(size_t /*begin*/, size_t /*end*/)>;
+
+  explicit ThreadPool(size_t nbThreads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // shared pool sized with the number of hardware threads
+  static ThreadPool& global();
+
+  size_t size() const noexcept;
+
+  template <class F>
+  std::future<typename std::result_of<F()>::type> submit(F f);
+
+  // splits [begin, end) in at most maxParallelism chunks and blocks until all are done
+  // maxParallelism == 0 means size() + 1 (workers + calling thread)
+  void parallelFor(size_t begin, size_t end, const Range& body, size_t maxParallelism = 0);
+
+ private:
+  void enqueue(std::function<void()> task);
+  void workerLoop();
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stop_{false};
+};
+
+template <class F>
+std::future<typename std::result_of<F()>::type> ThreadPool::submit(F f) {
+  using ResultType = typename std::result_of<F()>::type;
+  auto task = std::make_shared<std::packaged_task<ResultType()>>(std::move(f));
+  auto future = task->get_future();
+  if (workers_.empty()) {
+    (*task)();
+  } else {
+    enqueue([task] { (*task)(); });
+  }
+  return future;
+}
+
+}  // namespace s3d
+
+#endif  // S3D_CONCURRENCY_THREAD_POOL_H
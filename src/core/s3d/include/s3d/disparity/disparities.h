@@ -0,0 +1,45 @@
+#ifndef S3D_DISPARITY_DISPARITIES_H
+#define S3D_DISPARITY_DISPARITIES_H
+
+#include "s3d/image/image.h"
+#include "s3d/utilities/rule_of_five.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace s3d {
+
+// pixel position or displacement
+struct PixelPos {
+  int row;
+  int col;
+};
+
+struct DisparityPoint {
+  DisparityPoint(PixelPos leftPos, PixelPos disparity) : leftPos{leftPos}, disparity{disparity} {}
+
+  PixelPos leftPos;
+
+  // position in the right image - leftPos
+  PixelPos disparity;
+};
+
+/**
+ * Result of a DisparityAlgorithm.
+ *
+ * Disparity maps hold leftPos.col - right column (>= 0, searched towards the left as in
+ * block matching), 0 where there is no disparity.
+ */
+class Disparities : rule_of_five_interface<Disparities> {
+ public:
+  virtual const Image<uint8_t>& getDisparityMap() const = 0;
+  virtual std::vector<DisparityPoint> getDisparities() const = 0;
+
+  // smallest and largest disparity.col
+  virtual DisparityPoint min() const = 0;
+  virtual DisparityPoint max() const = 0;
+};
+
+}  // namespace s3d
+
+#endif  // S3D_DISPARITY_DISPARITIES_H
@@ -0,0 +1,34 @@
+#ifndef S3D_DISPARITY_DISPARITIES_DENSE_H
+#define S3D_DISPARITY_DISPARITIES_DENSE_H
+
+#include "s3d/disparity/disparities.h"
+
+namespace s3d {
+
+class DisparitiesDense : public Disparities {
+ public:
+  // min and max of the map, ignoring pixels without a disparity (0)
+  explicit DisparitiesDense(Image<uint8_t> disparityMap);
+
+  // min and max already known (e.g. reduced on the GPU), also without the 0 pixels
+  DisparitiesDense(Image<uint8_t> disparityMap, DisparityPoint min, DisparityPoint max);
+
+  gsl::owner<DisparitiesDense*> clone() const override;
+
+  const Image<uint8_t>& getDisparityMap() const override;
+
+  // one point per pixel with a disparity
+  std::vector<DisparityPoint> getDisparities() const override;
+
+  DisparityPoint min() const override;
+  DisparityPoint max() const override;
+
+ private:
+  Image<uint8_t> disparityMap_;
+  DisparityPoint min_;
+  DisparityPoint max_;
+};
+
+}  // namespace s3d
+
+#endif  // S3D_DISPARITY_DISPARITIES_DENSE_H
@@ -0,0 +1,30 @@
+#ifndef S3D_DISPARITY_DISPARITIES_SPARSE_H
+#define S3D_DISPARITY_DISPARITIES_SPARSE_H
+
+#include "s3d/disparity/disparities.h"
+#include "s3d/geometry/size.h"
+
+namespace s3d {
+
+class DisparitiesSparse : public Disparities {
+ public:
+  // the disparity map of imageSize is drawn at the left positions, clamped to [0, 255]
+  DisparitiesSparse(std::vector<DisparityPoint> disparities, Size imageSize);
+
+  gsl::owner<DisparitiesSparse*> clone() const override;
+
+  const Image<uint8_t>& getDisparityMap() const override;
+  std::vector<DisparityPoint> getDisparities() const override;
+
+  // disparity 0 at (0, 0) when there are no points
+  DisparityPoint min() const override;
+  DisparityPoint max() const override;
+
+ private:
+  std::vector<DisparityPoint> disparities_;
+  Image<uint8_t> disparityMap_;
+};
+
+}  // namespace s3d
+
+#endif  // S3D_DISPARITY_DISPARITIES_SPARSE_H
@@ -0,0 +1,22 @@
+#ifndef S3D_DISPARITY_DISPARITY_ALGORITHM_H
+#define S3D_DISPARITY_DISPARITY_ALGORITHM_H
+
+#include "s3d/disparity/disparities.h"
+#include "s3d/image/image.h"
+
+#include <memory>
+
+namespace s3d {
+
+// CPU implementations are in s3d, CUDA ones in s3d::cuda (s3dcuda)
+class DisparityAlgorithm {
+ public:
+  virtual ~DisparityAlgorithm() = default;
+
+  virtual std::unique_ptr<Disparities> ComputeDisparities(const Image<uint8_t>& leftImg,
+                                                          const Image<uint8_t>& rightImg) = 0;
+};
+
+}  // namespace s3d
+
+#endif  // S3D_DISPARITY_DISPARITY_ALGORITHM_H
@@ -0,0 +1,48 @@
+#ifndef S3D_DISPARITY_DISPARITY_ALGORITHM_BM_H
+#define S3D_DISPARITY_DISPARITY_ALGORITHM_BM_H
+
+#include "s3d/disparity/disparity_algorithm.h"
+
+#include <cstddef>
+
+namespace s3d {
+
+/**
+ * Block matching on the CPU, same output as cuda::DisparityAlgorithmBM (DisparitiesDense).
+ *
+ * Sums of absolute differences over square blocks are updated incrementally (column sums moved
+ * down the rows, block sums slid along them), all disparities at once. Rows are split on the
+ * global thread pool. Ambiguous pixels get disparity 0.
+ */
+class DisparityAlgorithmBM : public DisparityAlgorithm {
+ public:
+  // defaults of cv::cuda::createStereoBM
+  struct Parameters {
+    int nbDisparities{64};  // <= 256
+    int blockSize{19};      // odd
+    int uniquenessRatio{15};
+  };
+
+  DisparityAlgorithmBM() = default;
+  explicit DisparityAlgorithmBM(const Parameters& params);
+
+  // 1: sequential, 0: all available threads
+  void setNumberOfThreads(size_t nbThreads);
+
+  std::unique_ptr<Disparities> ComputeDisparities(const Image<uint8_t>& leftImg,
+                                                  const Image<uint8_t>& rightImg) override;
+
+ private:
+  void matchRows(const Image<uint8_t>& leftImg,
+                 const Image<uint8_t>& rightImg,
+                 int firstRow,
+                 int lastRow,
+                 Image<uint8_t>* disparityMap) const;
+
+  Parameters params_{};
+  size_t nbThreads_{0};
+};
+
+}  // namespace s3d
+
+#endif  // S3D_DISPARITY_DISPARITY_ALGORITHM_BM_H
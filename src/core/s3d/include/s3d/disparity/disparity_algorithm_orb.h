@@ -0,0 +1,42 @@
+#ifndef S3D_DISPARITY_DISPARITY_ALGORITHM_ORB_H
+#define S3D_DISPARITY_DISPARITY_ALGORITHM_ORB_H
+
+#include "s3d/disparity/disparity_algorithm.h"
+#include "s3d/features/binary_descriptor_matcher.h"
+#include "s3d/features/orb_extractor.h"
+
+#include <cstddef>
+
+namespace s3d {
+
+/**
+ * ORB features matched between the views on the CPU, same output as cuda::DisparityAlgorithmORB
+ * (DisparitiesSparse): brute-force Hamming matching of each left feature, kept when its best
+ * match passes the ratio test.
+ */
+class DisparityAlgorithmORB : public DisparityAlgorithm {
+ public:
+  static constexpr float MAX_DISTANCE_RATIO = 0.8f;
+
+  DisparityAlgorithmORB() = default;
+  explicit DisparityAlgorithmORB(const OrbExtractor::Parameters& params);
+
+  // 1: sequential, 0: all available threads
+  void setNumberOfThreads(size_t nbThreads);
+
+  std::unique_ptr<Disparities> ComputeDisparities(const Image<uint8_t>& leftImg,
+                                                  const Image<uint8_t>& rightImg) override;
+
+ private:
+  OrbExtractor extractor_{};
+  BinaryDescriptorMatcher matcher_{};
+
+  std::vector<OrbExtractor::Keypoint> keypointsLeft_{};
+  std::vector<OrbExtractor::Keypoint> keypointsRight_{};
+  std::vector<uint8_t> descriptorsLeft_{};
+  std::vector<uint8_t> descriptorsRight_{};
+};
+
+}  // namespace s3d
+
+#endif  // S3D_DISPARITY_DISPARITY_ALGORITHM_ORB_H
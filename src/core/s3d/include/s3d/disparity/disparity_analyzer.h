@@ -8,7 +8,7 @@
 
 namespace s3d {
 
-// todo: this is DisparityAnalyzerSparse, could have a DisparityAnalyzerDense
+// sparse (DisparityAnalyzerSTAN) or dense (DisparityAnalyzerSGM, without feature points)
 class DisparityAnalyzer : rule_of_five_interface<DisparityAnalyzer> {
   virtual bool analyze(const Image<uint8_t>& leftImage, const Image<uint8_t>& rightImage) = 0;
   virtual const std::vector<float>& getDisparitiesPercent() const = 0;
@@ -0,0 +1,107 @@
+#ifndef S3D_DISPARITY_DISPARITY_ANALYZER_SGM_H
+#define S3D_DISPARITY_DISPARITY_ANALYZER_SGM_H
+
+#include "s3d/disparity/disparity_analyzer.h"
+#include "s3d/image/image_container.h"
+#include "s3d/utilities/stats.h"
+
+#include <gsl/gsl>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace s3d {
+
+/**
+ * Dense disparity analysis on the CPU: semi-global matching (H. Hirschmuller, 2008) of a 9x7
+ * census transform (Hamming distance costs).
+ *
+ * Costs are aggregated along 4 scanlines (left/right parallel over rows, up/down parallel over
+ * columns), with SIMD over disparities. Disparities are chosen winner takes all, refined to
+ * subpixel, and rejected when ambiguous or inconsistent with the right image (NaN in the map).
+ *
+ * Disparities are xRight - xLeft, like compute_disparities. There are no feature points.
+ */
+class DisparityAnalyzerSGM : public DisparityAnalyzer {
+ public:
+  struct Parameters {
+    // searched disparities are [minDisparity, minDisparity + nbDisparities), in pixels
+    int minDisparity{-32};
+    int nbDisparities{64};  // multiple of 16
+
+    // penalties of disparity changes of 1 pixel and of more than 1 pixel between neighbours
+    uint16_t p1{7};
+    uint16_t p2{86};
+
+    // best cost must be lower than the second best (not neighbour) by this percent
+    int uniquenessRatio{10};
+
+    // max difference with the disparity of the right image, < 0 disables the check
+    int maxLeftRightDifference{1};
+  };
+
+  struct Results {
+    // same size as the images, NaN where the disparity is invalid
+    Image<float> disparityMap{};
+
+    // 3rd and 97th percentiles of the valid disparities, in percent of the image width (0 when no
+    // disparity is valid)
+    double minDisparityPercent{};
+    double maxDisparityPercent{};
+
+    // valid disparities in [minDisparityPercent, maxDisparityPercent]
+    std::vector<float> disparitiesPercent{};
+  };
+
+  DisparityAnalyzerSGM();
+  explicit DisparityAnalyzerSGM(const Parameters& params);
+
+  gsl::owner<DisparityAnalyzerSGM*> clone() const override;
+
+  void setParameters(const Parameters& params);
+  const Parameters& getParameters() const;
+
+  // 1: sequential, 0: all available threads
+  void setNumberOfThreads(size_t nbThreads);
+
+  // false when no disparity is valid
+  bool analyze(const Image<uint8_t>& leftImage, const Image<uint8_t>& rightImage) override;
+  const std::vector<float>& getDisparitiesPercent() const override;
+  const std::vector<Eigen::Vector2f>& getFeaturePointsLeft() const override;
+  const std::vector<Eigen::Vector2f>& getFeaturePointsRight() const override;
+
+  // outputs
+  Results results;
+
+ private:
+  void computeCensus(const Image<uint8_t>& image, std::vector<uint64_t>* census) const;
+  void computeCosts();
+  void aggregateHorizontal();
+  void aggregateVertical();
+  void computeDisparityMap();
+  void computeStatistics();
+  void clearStatistics();
+
+  Parameters params_{};
+  size_t nbThreads_{0};
+  int width_{0};
+  int height_{0};
+
+  std::vector<uint64_t> censusLeft_{};
+  std::vector<uint64_t> censusRight_{};
+
+  // [y][x][d] volumes
+  std::vector<uint8_t> costs_{};
+  std::vector<uint16_t> aggregatedCosts_{};
+
+  std::vector<float> validDisparities_{};
+  Quantiles<float> quantiles_{};
+  std::vector<float> range_{};
+
+  std::vector<Eigen::Vector2f> noFeaturePoints_{};
+};
+
+}  // namespace s3d
+
+#endif  // S3D_DISPARITY_DISPARITY_ANALYZER_SGM_H
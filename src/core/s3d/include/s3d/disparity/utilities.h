@@ -21,10 +21,19 @@ void compute_disparities(const std::vector<Eigen::Vector2d>& positionsLeft,
   }
 };
 
+// 3rd and 97th percentiles, quantiles and range buffers are reused between calls (e.g. per frame)
+inline std::pair<double, double> disparity_range(const std::vector<double>& disparities,
+                                                 Quantiles<double>* quantiles,
+                                                 std::vector<double>* range) {
+  static const std::vector<float> percentiles{0.03f, 0.97f};
+  quantiles->percentiles(disparities, percentiles, range);
+  return {(*range)[0], (*range)[1]};
+};
+
 inline std::pair<double, double> disparity_range(const std::vector<double>& disparities) {
-  auto min = s3d::percentile(disparities, 0.03f);
-  auto max = s3d::percentile(disparities, 0.97f);
-  return {min, max};
+  Quantiles<double> quantiles;
+  std::vector<double> range;
+  return disparity_range(disparities, &quantiles, &range);
 };
 
 inline std::pair<double, double> disparity_range(
@@ -0,0 +1,46 @@
+#ifndef S3D_FEATURES_BINARY_DESCRIPTOR_MATCHER_H
+#define S3D_FEATURES_BINARY_DESCRIPTOR_MATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace s3d {
+
+/**
+ * Brute-force Hamming matcher for 256 bits binary descriptors (e.g. ORB, BRIEF-32).
+ *
+ * Descriptors are contiguous rows of DESCRIPTOR_SIZE bytes. Train descriptors are
+ * processed by blocks kept in cache while a block of queries is compared against them,
+ * query blocks are distributed on the global ThreadPool.
+ */
+class BinaryDescriptorMatcher {
+ public:
+  static constexpr size_t DESCRIPTOR_SIZE = 32;
+
+  // two nearest train descriptors of a query, for ratio test
+  struct BestMatches {
+    int trainIdx{-1};
+    int distance{std::numeric_limits<int>::max()};
+    int secondTrainIdx{-1};
+    int secondDistance{std::numeric_limits<int>::max()};
+  };
+
+  // 0: use all available threads, 1: run sequentially
+  void setNumberOfThreads(size_t nbThreads);
+
+  std::vector<BestMatches> knnMatch(const uint8_t* queries,
+                                    size_t nbQueries,
+                                    const uint8_t* train,
+                                    size_t nbTrain) const;
+
+  static int hammingDistance(const uint8_t* a, const uint8_t* b);
+
+ private:
+  size_t nbThreads_{0};
+};
+
+}  // namespace s3d
+
+#endif  // S3D_FEATURES_BINARY_DESCRIPTOR_MATCHER_H
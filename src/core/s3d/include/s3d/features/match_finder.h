@@ -12,11 +12,20 @@ namespace s3d {
 class MatchFinder {
  public:
   using Position = Eigen::Vector2d;
-  using Matches = std::vector<std::vector<Position>>;
   using Images = std::vector<Image<uint8_t>>;
 
   // match.[0][i] <-- matches --> match.[1][i]
+  // qualities[i]: higher is better, empty when the finder does not rank its matches
+  struct Matches : std::vector<std::vector<Position>> {
+    using std::vector<std::vector<Position>>::vector;
+
+    std::vector<double> qualities{};
+  };
+
   virtual Matches findMatches(const Images& images) = 0;
+
+  // best matches first (e.g. for PROSAC sampling), stable for equal qualities
+  static void sortByQuality(Matches* matches);
 };
 
 }  // namespace s3d
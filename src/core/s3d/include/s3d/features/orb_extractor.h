@@ -0,0 +1,60 @@
+#ifndef S3D_FEATURES_ORB_EXTRACTOR_H
+#define S3D_FEATURES_ORB_EXTRACTOR_H
+
+#include "s3d/image/image.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace s3d {
+
+/**
+ * ORB features on the CPU (E. Rublee et al., "ORB: an efficient alternative to SIFT or SURF").
+ *
+ * FAST-9 corners ranked by Harris response, oriented by intensity centroid, described by steered
+ * BRIEF tests on a smoothed image (256 bits, for BinaryDescriptorMatcher). Single scale: meant for
+ * the two views of a stereo pair. The test pairs are drawn once from a fixed seed (Gaussian, as
+ * in BRIEF), descriptors cannot be matched with OpenCV's learned pattern.
+ *
+ * Rows and keypoints are split on the global thread pool.
+ */
+class OrbExtractor {
+ public:
+  // defaults of cv::ORB
+  struct Parameters {
+    size_t maxNbFeatures{500};
+    int fastThreshold{20};
+  };
+
+  struct Keypoint {
+    float x;
+    float y;
+    float angle;  // radians
+    float response;
+  };
+
+  OrbExtractor() = default;
+  explicit OrbExtractor(const Parameters& params);
+
+  // 1: sequential, 0: all available threads
+  void setNumberOfThreads(size_t nbThreads);
+
+  // strongest first, descriptors[i * DESCRIPTOR_SIZE] is the descriptor of keypoints[i]
+  void detectAndCompute(const Image<uint8_t>& image,
+                        std::vector<Keypoint>* keypoints,
+                        std::vector<uint8_t>* descriptors) const;
+
+ private:
+  void detect(const Image<uint8_t>& image, std::vector<Keypoint>* keypoints) const;
+  void compute(const Image<uint8_t>& image,
+               std::vector<Keypoint>* keypoints,
+               std::vector<uint8_t>* descriptors) const;
+
+  Parameters params_{};
+  size_t nbThreads_{0};
+};
+
+}  // namespace s3d
+
+#endif  // S3D_FEATURES_ORB_EXTRACTOR_H
@@ -0,0 +1,61 @@
+#ifndef S3D_IMAGE_IMAGE_PYRAMID_H
+#define S3D_IMAGE_IMAGE_PYRAMID_H
+
+#include "s3d/geometry/size.h"
+#include "s3d/image/image.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace s3d {
+
+/**
+ * Grayscale pyramid, each level is half the size of the previous one (2x2 box filter).
+ *
+ * Meant to be built once per frame and shared by the analysis stages, only feature tracking uses it
+ * for now: ScaleImages and the analysis scale of DisparityAnalyzerSTAN accept any ratio and resize
+ * with cv::resize before, the tracking pyramid is built on that resized image.
+ * Levels can be surrounded by replicated border pixels for consumers reading outside
+ * the image (e.g. optical flow windows). Buffers are kept between builds.
+ */
+class ImagePyramid {
+ public:
+  // stops early when a level would be smaller than 2x2
+  void build(const uint8_t* data, Size size, size_t stride, int nbLevels, int border = 0);
+  void build(const Image<uint8_t>& image, int nbLevels, int border = 0);
+
+  void clear();
+
+  int nbLevels() const;
+  int border() const;
+
+  Size levelSize(int level) const;
+
+  // first pixel of the level, border pixels are before and after each row
+  const uint8_t* levelData(int level) const;
+
+  // distance in bytes between two rows of a level, border included
+  size_t levelStride(int level) const;
+
+  // level coordinates = scale * full resolution coordinates
+  static float levelScale(int level);
+
+ private:
+  struct Level {
+    Size size;
+    std::vector<uint8_t> buffer;
+  };
+
+  uint8_t* levelData(int level);
+  void allocateLevel(int level, Size size);
+  void replicateBorder(int level);
+
+  std::vector<Level> levels_;
+  int nbLevels_{0};
+  int border_{0};
+};
+
+}  // namespace s3d
+
+#endif  // S3D_IMAGE_IMAGE_PYRAMID_H
@@ -1,9 +1,12 @@
 #ifndef S3D_MULTIVIEW_SAMPSON_DISTANCE_FUNCTION_H
 #define S3D_MULTIVIEW_SAMPSON_DISTANCE_FUNCTION_H
 
+#include "s3d/robust/distance_samples.h"
+
 // std::vector requires complete type
 #include "s3d/utilities/eigen.h"
 
+#include <cstddef>
 #include <vector>
 
 namespace s3d {
@@ -15,12 +18,108 @@ class SampsonDistanceFunction {
   using SampleType = Eigen::Vector3d;
   using ModelType = StanAlignment;
 
+  // distance of one correspondence at a time (e.g. SPRT verification), F is computed once
+  class SampleDistance {
+   public:
+    explicit SampleDistance(const ModelType& model);
+
+    double operator()(const SampleType& pt1, const SampleType& pt2) const {
+      const Eigen::Vector3d epl1 = f_ * pt1;
+      const Eigen::Vector3d epl2 = ft_ * pt2;
+      const double pfp = pt2.dot(epl1);
+      const double coeff =
+          epl1[0] * epl1[0] + epl1[1] * epl1[1] + epl2[0] * epl2[0] + epl2[1] * epl2[1];
+      return pfp * pfp / coeff;
+    }
+
+   private:
+    Eigen::Matrix3d f_;
+    Eigen::Matrix3d ft_;
+  };
+
+  // borrowed range of SoaSamples, read by the SIMD kernel and the robust estimators
+  struct SoaView {
+    size_t size() const { return nb; }
+
+    SampleType sample1(size_t i) const { return {x1[i], y1[i], 1.0}; }
+    SampleType sample2(size_t i) const { return {x2[i], y2[i], 1.0}; }
+
+    const double* x1;
+    const double* y1;
+    const double* x2;
+    const double* y2;
+    size_t nb;
+  };
+
+  // structure of arrays of the inhomogeneous coordinates, for the SIMD kernel
+  struct SoaSamples {
+    SoaSamples() = default;
+    SoaSamples(const std::vector<SampleType>& pts1, const std::vector<SampleType>& pts2);
+
+    size_t size() const { return x1.size(); }
+    void resize(size_t nb);
+
+    SoaView view() const { return view(0, size()); }
+    SoaView view(size_t begin, size_t end) const;
+
+    std::vector<double> x1, y1, x2, y2;
+  };
+
   static void ComputeDistance(const std::vector<SampleType>& pts1,
                               const std::vector<SampleType>& pts2,
                               const ModelType& model,
                               std::vector<double>* distances);
+
+  // writes distances[begin, end), AVX2 when available
+  static void ComputeDistance(const SoaView& samples,
+                              const ModelType& model,
+                              size_t begin,
+                              size_t end,
+                              double* distances);
 };
 
+namespace robust {
+
+// samples are converted once per estimation to the SIMD layout, or borrowed when already in it
+template <>
+class DistanceSamples<SampsonDistanceFunction> {
+ public:
+  using SampleType = SampsonDistanceFunction::SampleType;
+  using Samples = std::vector<SampleType>;
+
+  DistanceSamples(const Samples& samples1, const Samples& samples2)
+      : soa_{samples1, samples2}, view_{soa_.view()} {}
+
+  // samples must outlive this object
+  explicit DistanceSamples(const SampsonDistanceFunction::SoaView& samples) : view_{samples} {}
+
+  // view_ may refer to soa_
+  DistanceSamples(const DistanceSamples&) = delete;
+  DistanceSamples& operator=(const DistanceSamples&) = delete;
+
+  size_t size() const { return view_.size(); }
+
+  SampleType sample1(size_t i) const { return view_.sample1(i); }
+  SampleType sample2(size_t i) const { return view_.sample2(i); }
+
+  void computeDistances(const StanAlignment& model, std::vector<double>* distances) const {
+    SampsonDistanceFunction::ComputeDistance(view_, model, 0, view_.size(), distances->data());
+  }
+
+  void computeDistances(const StanAlignment& model,
+                        size_t begin,
+                        size_t end,
+                        std::vector<double>* distances) const {
+    SampsonDistanceFunction::ComputeDistance(view_, model, begin, end, distances->data());
+  }
+
+ private:
+  SampsonDistanceFunction::SoaSamples soa_{};
+  SampsonDistanceFunction::SoaView view_;
+};
+
+}  // namespace robust
+
 }  // namespace s3d
 
 #endif  // S3D_MULTIVIEW_SAMPSON_DISTANCE_FUNCTION_H
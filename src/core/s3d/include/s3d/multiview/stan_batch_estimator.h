@@ -0,0 +1,69 @@
+#ifndef S3D_MULTIVIEW_STAN_BATCH_ESTIMATOR_H
+#define S3D_MULTIVIEW_STAN_BATCH_ESTIMATOR_H
+
+#include "s3d/features/match_finder.h"
+#include "s3d/geometry/size.h"
+#include "s3d/multiview/sampson_distance_function.h"
+#include "s3d/multiview/stan_alignment.h"
+#include "s3d/multiview/stan_fundamental_matrix_solver.h"
+#include "s3d/robust/lmeds.h"
+#include "s3d/robust/parameters.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace s3d {
+
+/**
+ * STAN alignments of many frames at once, for offline analysis (e.g. quality control of a video).
+ *
+ * Correspondences of all frames are centered and stored once, in the structure of arrays of the
+ * SIMD Sampson distance. Frames are then estimated concurrently on the global thread pool, one
+ * sequential LMedS per frame borrowing its range of the shared arrays (same estimator and
+ * parameters as DisparityAnalyzerSTAN).
+ */
+class StanBatchEstimator {
+ public:
+  using Estimator = robust::Lmeds<StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+
+  struct FrameResult {
+    // false when the frame has too few correspondences or inliers
+    bool valid{false};
+    StanAlignment alignment{};
+    size_t nbInliers{0};
+  };
+
+  // all frames have the same size, points are centered on the image center
+  explicit StanBatchEstimator(Size imageSize);
+
+  // seed >= 0: frame i is estimated with seed + i, results do not depend on the number of threads
+  void setParameters(const robust::Parameters& params);
+
+  // 1: sequential, 0: all available threads
+  void setNumberOfThreads(size_t nbThreads);
+
+  // frames[i] are the correspondences of frame i, as found by a MatchFinder
+  std::vector<FrameResult> estimate(const std::vector<MatchFinder::Matches>& frames);
+
+  // each parameter averaged over the valid frames of [i - radius, i + radius], weighted by their
+  // number of inliers, frames without valid neighbours keep their own alignment
+  static std::vector<StanAlignment> smoothTrack(const std::vector<FrameResult>& results,
+                                                size_t radius);
+
+ private:
+  void fillSharedPoints(const std::vector<MatchFinder::Matches>& frames);
+  FrameResult estimateFrame(size_t frame) const;
+
+  double centerX_;
+  double centerY_;
+  robust::Parameters params_{};
+  size_t nbThreads_{0};
+
+  // points of frame i are in [offsets_[i], offsets_[i + 1])
+  SampsonDistanceFunction::SoaSamples points_{};
+  std::vector<size_t> offsets_{};
+};
+
+}  // namespace s3d
+
+#endif  // S3D_MULTIVIEW_STAN_BATCH_ESTIMATOR_H
@@ -2,6 +2,7 @@
 #define S3D_MULTIVIEW_STAN_FUNDAMENTAL_MATRIX_SOLVER_H
 
 #include "s3d/robust/estimation_algorithm_traits.h"
+#include "s3d/robust/parameters.h"
 #include "s3d/multiview/stan_alignment.h"
 #include "s3d/geometry/size.h"
 
@@ -17,6 +18,19 @@ class StanFundamentalMatrixSolver {
   using SampleType = Eigen::Vector3d;
   using ModelType = StanAlignment;
 
+  // least squares A^T A x = A^T b, accumulated in one pass over the correspondences
+  class NormalEquations {
+   public:
+    void add(const SampleType& x, const SampleType& xp);
+    ModelType solve() const;
+
+   private:
+    Eigen::Matrix<double, 5, 5> AtA_{Eigen::Matrix<double, 5, 5>::Zero()};
+    Eigen::Matrix<double, 5, 1> Atb_{Eigen::Matrix<double, 5, 1>::Zero()};
+  };
+
+  // minimal samples: direct 5x5 LU solve, more samples: normal equations
+
   static ModelType ComputeModel(const std::vector<SampleType>& pts1,
                                 const std::vector<SampleType>& pts2);
 
@@ -27,6 +41,19 @@ class StanFundamentalMatrixSolver {
   static Eigen::Matrix3d FundamentalMatrixFromAlignment(const StanAlignment& a);
 
   static Eigen::Matrix3d CenteredFundamentalMatrixFromAlignment(const StanAlignment& a, const Size& imageSize);
+
+  // alignment of the same images resized by scale (e.g. 1 / analysis scale to full resolution),
+  // the angles and the zoom are kept, the pixel and per pixel terms change
+  static StanAlignment ScaledAlignment(const StanAlignment& a, double scale);
+
+  // robust estimation of centered correspondences in pixels (DisparityAnalyzerSTAN,
+  // StanBatchEstimator): 500 trials, Sampson distance threshold of a 0.5 pixel noise
+  static robust::Parameters RobustParameters();
+
+ private:
+  // one row of A x = b for the correspondence x <-> xp
+  template <class Row>
+  static void FillEquation(const SampleType& x, const SampleType& xp, Row&& row, double* b);
 };
 
 namespace robust {
@@ -0,0 +1,58 @@
+#ifndef S3D_ROBUST_DISTANCE_SAMPLES_H
+#define S3D_ROBUST_DISTANCE_SAMPLES_H
+
+#include <cstddef>
+#include <vector>
+
+namespace s3d {
+namespace robust {
+
+/**
+ * Samples as seen by DistanceFunction, built once per estimation by the sampler, which also draws
+ * its minimal samples from it (sample1, sample2).
+ *
+ * Refers to the sampler samples by default, distance functions with a faster layout
+ * (e.g. structure of arrays for SIMD) specialize it, and may borrow samples already in it.
+ */
+template<class DistanceFunction>
+class DistanceSamples {
+public:
+  using SampleType = typename DistanceFunction::SampleType;
+  using Samples = std::vector<SampleType>;
+
+  DistanceSamples(const Samples& samples1, const Samples& samples2)
+    : samples1_{&samples1}
+    , samples2_{&samples2}
+  {}
+
+  size_t size() const { return samples1_->size(); }
+
+  const SampleType& sample1(size_t i) const { return (*samples1_)[i]; }
+  const SampleType& sample2(size_t i) const { return (*samples2_)[i]; }
+
+  template<class ModelType>
+  void computeDistances(const ModelType& model, std::vector<double>* distances) const {
+    DistanceFunction::ComputeDistance(*samples1_, *samples2_, model, distances);
+  }
+
+  // only [begin, end) is written, requires DistanceFunction::SampleDistance
+  template<class ModelType>
+  void computeDistances(const ModelType& model,
+                        size_t begin,
+                        size_t end,
+                        std::vector<double>* distances) const {
+    const typename DistanceFunction::SampleDistance distance(model);
+    for (size_t i = begin; i < end; ++i) {
+      (*distances)[i] = distance((*samples1_)[i], (*samples2_)[i]);
+    }
+  }
+
+private:
+  const Samples* samples1_;
+  const Samples* samples2_;
+};
+
+} // namespace robust
+} // namespace s3d
+
+#endif //S3D_ROBUST_DISTANCE_SAMPLES_H
@@ -0,0 +1,195 @@
+#ifndef S3D_ROBUST_INCREMENTAL_ESTIMATOR_H
+#define S3D_ROBUST_INCREMENTAL_ESTIMATOR_H
+
+#include "s3d/robust/distance_samples.h"
+#include "s3d/robust/estimation_algorithm_traits.h"
+#include "s3d/robust/inlier_mask.h"
+#include "s3d/robust/lmeds.h"
+#include "s3d/robust/parameters.h"
+#include "s3d/robust/ransac.h"  // NotEnoughInliersFound
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace s3d {
+namespace robust {
+
+/**
+ * Robust estimation over a sequence of sample sets (e.g. video frames), warm started from the
+ * model of the previous set.
+ *
+ * The previous model is scored first, as a single hypothesis. While its inlier ratio stays above
+ * MIN_SCORE_RATIO times the ratio of the last full estimation, it is only refined by least squares
+ * on its inliers (kept when it does not lose inliers). Otherwise Estimator (Ransac, Lmeds) runs on
+ * all samples and its model is refined the same way. ModelSolver must fit more than a minimal
+ * sample.
+ *
+ * Inliers are the samples within params.distanceThreshold of the model, whichever path ran.
+ */
+template<class ModelSolver,
+         class DistanceFunction,
+         class Estimator = Lmeds<ModelSolver, DistanceFunction>>
+class IncrementalEstimator {
+public:
+  using SampleType = typename estimation_algorithm_traits<ModelSolver>::SampleType;
+  using ModelType = typename estimation_algorithm_traits<ModelSolver>::ModelType;
+  using Samples = std::vector<SampleType>;
+
+  static constexpr size_t MIN_NB_SAMPLES = estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES;
+  static constexpr double MIN_SCORE_RATIO = 0.9;
+  static constexpr size_t NB_REFINEMENT_ITERATIONS = 2;
+
+  explicit IncrementalEstimator(Parameters params) : params_(params) {}
+
+  // throws NotEnoughInliersFound, the next call is then a full estimation
+  ModelType operator()(Samples samples1, Samples samples2) {
+    assert(samples1.size() == samples2.size());
+    samples1_ = std::move(samples1);
+    samples2_ = std::move(samples2);
+    distanceSamples_ = std::make_unique<DistanceSamples<DistanceFunction>>(samples1_, samples2_);
+    return estimate([this](Estimator* estimator) { return (*estimator)(samples1_, samples2_); });
+  }
+
+  // borrows samples already in the layout of DistanceSamples<DistanceFunction>
+  // (e.g. SampsonDistanceFunction::SoaView), they must outlive the estimator
+  template<class SamplesView>
+  ModelType operator()(const SamplesView& samples) {
+    samples1_.clear();
+    samples2_.clear();
+    distanceSamples_ = std::make_unique<DistanceSamples<DistanceFunction>>(samples);
+    return estimate([&samples](Estimator* estimator) { return (*estimator)(samples); });
+  }
+
+  std::pair<Samples, Samples> getBestInlierSamples() const {
+    std::pair<Samples, Samples> inliers;
+    inliers_.forEachSet([this, &inliers](size_t i) {
+      inliers.first.push_back(distanceSamples_->sample1(i));
+      inliers.second.push_back(distanceSamples_->sample2(i));
+    });
+    return inliers;
+  }
+
+  // indexes the samples given to operator(), to filter them without copies
+  const InlierMask& getBestInlierMask() const { return inliers_; }
+
+  // forgets the previous model (e.g. on a scene cut)
+  void reset() { hasModel_ = false; }
+
+  // false when the last model comes from a full estimation
+  bool wasWarmStarted() const { return lastWasWarmStarted_; }
+
+  size_t getNbWarmStarts() const { return nbWarmStarts_; }
+  size_t getNbFullEstimations() const { return nbFullEstimations_; }
+
+private:
+  // fullEstimation(Estimator*) runs the estimator on the samples of distanceSamples_
+  template<class FullEstimation>
+  ModelType estimate(FullEstimation fullEstimation) {
+    const auto& distanceSamples = *distanceSamples_;
+    const size_t nbSamples = distanceSamples.size();
+    distances_.resize(nbSamples);
+    if (inliers_.size() != nbSamples) {
+      inliers_ = InlierMask(nbSamples);
+      refinedInliers_ = InlierMask(nbSamples);
+    }
+
+    lastWasWarmStarted_ = hasModel_ && refine(distanceSamples);
+    if (lastWasWarmStarted_) {
+      ++nbWarmStarts_;
+      return model_;
+    }
+
+    hasModel_ = false;
+    if (nbSamples < MIN_NB_SAMPLES) {
+      throw NotEnoughInliersFound(MIN_NB_SAMPLES, nbSamples);
+    }
+    Estimator estimator(params_);
+    model_ = fullEstimation(&estimator);
+    ++nbFullEstimations_;
+
+    distanceSamples.computeDistances(model_, &distances_);
+    size_t nbInliers = inliers_.fill(distances_, params_.distanceThreshold);
+    if (nbInliers < MIN_NB_SAMPLES) {
+      throw NotEnoughInliersFound(MIN_NB_SAMPLES, nbInliers);
+    }
+    if (nbInliers > MIN_NB_SAMPLES) {
+      nbInliers = refineOnInliers(distanceSamples, nbInliers);
+    }
+    referenceRatio_ = static_cast<double>(nbInliers) / static_cast<double>(nbSamples);
+    hasModel_ = true;
+    return model_;
+  }
+
+  // true when the previous model still holds, model_ and inliers_ are then updated
+  bool refine(const DistanceSamples<DistanceFunction>& distanceSamples) {
+    distanceSamples.computeDistances(model_, &distances_);
+    size_t nbInliers = inliers_.fill(distances_, params_.distanceThreshold);
+    const double ratio =
+        static_cast<double>(nbInliers) / static_cast<double>(distanceSamples.size());
+    if (nbInliers <= MIN_NB_SAMPLES || ratio < MIN_SCORE_RATIO * referenceRatio_) {
+      return false;
+    }
+    refineOnInliers(distanceSamples, nbInliers);
+    return true;
+  }
+
+  // least squares on the inliers of model_, returns the number of inliers of the kept model
+  size_t refineOnInliers(const DistanceSamples<DistanceFunction>& distanceSamples,
+                         size_t nbInliers) {
+    for (size_t i = 0; i < NB_REFINEMENT_ITERATIONS; ++i) {
+      subset1_.clear();
+      subset2_.clear();
+      inliers_.forEachSet([this, &distanceSamples](size_t j) {
+        subset1_.push_back(distanceSamples.sample1(j));
+        subset2_.push_back(distanceSamples.sample2(j));
+      });
+      const ModelType refined = ModelSolver::ComputeModel(subset1_, subset2_);
+
+      distanceSamples.computeDistances(refined, &distances_);
+      const size_t nbRefinedInliers = refinedInliers_.fill(distances_, params_.distanceThreshold);
+      if (nbRefinedInliers < nbInliers) {
+        break;
+      }
+      model_ = refined;
+      nbInliers = nbRefinedInliers;
+      inliers_.swap(refinedInliers_);
+    }
+    return nbInliers;
+  }
+
+  Parameters params_;
+
+  bool hasModel_{false};
+  bool lastWasWarmStarted_{false};
+  ModelType model_{};
+  double referenceRatio_{0.0};
+
+  // empty when the samples are borrowed
+  Samples samples1_{};
+  Samples samples2_{};
+  std::unique_ptr<DistanceSamples<DistanceFunction>> distanceSamples_{};
+  std::vector<double> distances_{};
+  InlierMask inliers_{};
+  InlierMask refinedInliers_{};
+  Samples subset1_{};
+  Samples subset2_{};
+
+  size_t nbWarmStarts_{0};
+  size_t nbFullEstimations_{0};
+};
+
+template<class ModelSolver, class DistanceFunction, class Estimator>
+constexpr size_t IncrementalEstimator<ModelSolver, DistanceFunction, Estimator>::MIN_NB_SAMPLES;
+template<class ModelSolver, class DistanceFunction, class Estimator>
+constexpr double IncrementalEstimator<ModelSolver, DistanceFunction, Estimator>::MIN_SCORE_RATIO;
+template<class ModelSolver, class DistanceFunction, class Estimator>
+constexpr size_t
+    IncrementalEstimator<ModelSolver, DistanceFunction, Estimator>::NB_REFINEMENT_ITERATIONS;
+
+} // namespace robust
+} // namespace s3d
+
+#endif //S3D_ROBUST_INCREMENTAL_ESTIMATOR_H
@@ -0,0 +1,73 @@
+#ifndef S3D_ROBUST_INLIER_MASK_H
+#define S3D_ROBUST_INLIER_MASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace s3d {
+namespace robust {
+
+/**
+ * One bit per sample, packed in 64 bits words (bits past size() are always 0).
+ *
+ * Built with SIMD compares of the distances, counted with popcount and swapped instead of copied
+ * when a better hypothesis is found.
+ */
+class InlierMask {
+public:
+  static constexpr size_t WORD_SIZE = 64;
+
+  InlierMask() = default;
+  explicit InlierMask(size_t size);
+
+  // bit i is set when distances[i] <= distanceThreshold, returns the number of set bits
+  size_t fill(const std::vector<double>& distances, double distanceThreshold);
+
+  size_t size() const noexcept { return size_; }
+
+  size_t count() const;
+
+  bool operator[](size_t i) const {
+    return ((words_[i / WORD_SIZE] >> (i % WORD_SIZE)) & 1U) != 0;
+  }
+
+  void set(size_t i, bool value);
+
+  // f(i) for each set bit, in increasing order
+  template <class F>
+  void forEachSet(F f) const {
+    for (size_t w = 0; w < words_.size(); ++w) {
+      for (uint64_t word = words_[w]; word != 0; word &= word - 1) {
+        f(w * WORD_SIZE + countTrailingZeros(word));
+      }
+    }
+  }
+
+  const std::vector<uint64_t>& words() const noexcept { return words_; }
+
+  void swap(InlierMask& other) noexcept;
+
+private:
+  // word != 0
+  static size_t countTrailingZeros(uint64_t word) {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_ctzll(word));
+#else
+    size_t n = 0;
+    while ((word & 1U) == 0) {
+      word >>= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  size_t size_{0};
+  std::vector<uint64_t> words_{};
+};
+
+}  // namespace robust
+}  // namespace s3d
+
+#endif  // S3D_ROBUST_INLIER_MASK_H
@@ -1,6 +1,8 @@
 #ifndef S3D_ROBUST_INLIERS_H
 #define S3D_ROBUST_INLIERS_H
 
+#include "s3d/robust/inlier_mask.h"
+
 #include <limits>
 #include <vector>
 #include <cstddef> // size_t
@@ -23,27 +25,33 @@ public:
 
   virtual void updateCurrent(const std::vector<double> &distances);
 
-  virtual std::pair<std::vector<bool>, size_t> computeInliers(const std::vector<double> &distances);
+  // writes in inliers, returns the number of inliers
+  virtual size_t computeInliers(const std::vector<double> &distances, InlierMask *inliers);
 
   size_t getCurrentNb() const noexcept;
 
   size_t getBestNb() const noexcept;
 
+  // higher is better, to compare the best of several Inliers
+  virtual double getBestScore() const;
+
   double getDistanceThreshold() const;
 
-  const std::vector<bool> &getBest() const noexcept;
+  const InlierMask &getBest() const noexcept;
 
   bool wereLastBest();
 
 private:
   size_t currentNb_{0};
-  std::vector<bool> current_;
+  InlierMask current_;
   size_t bestNb_{0};
-  std::vector<bool> best_;
+  InlierMask best_;
   bool lastWasBest_{false};
 
 protected:
-  virtual std::pair<std::vector<bool>, size_t> computeInliers(const std::vector<double> &distances, double distanceThreshold);
+  static size_t computeInliers(const std::vector<double> &distances,
+                               double distanceThreshold,
+                               InlierMask *inliers);
 
   double distanceThreshold_;
 };
@@ -61,10 +69,36 @@ public :
 
   bool currentInliersAreBetter() const override;
 
-  std::pair<std::vector<bool>, size_t> computeInliers(const std::vector<double> &distances) override;
+  size_t computeInliers(const std::vector<double> &distances, InlierMask *inliers) override;
+
+  double getBestMedian() const noexcept;
+
+  double getBestScore() const override;
 
 private:
   double bestDist_{std::numeric_limits<double>::max()};
+  std::vector<double> sortedDistances_{};
+};
+
+/**
+ * Uses MSAC strategy (Torr & Zisserman, 2000): lowest sum of min(distance², threshold²),
+ * inliers are the same as RANSAC
+ */
+class InliersMSAC : public Inliers {
+public:
+  explicit InliersMSAC(size_t nbPts, double distanceThreshold);
+
+  void updateCurrent(const std::vector<double> &distances) override;
+
+  void chooseCurrentInliersAsBest() override;
+
+  bool currentInliersAreBetter() const override;
+
+  double getBestScore() const override;
+
+private:
+  double currentCost_{0.0};
+  double bestCost_{std::numeric_limits<double>::max()};
 };
 
 } // namespace robust
@@ -4,11 +4,15 @@
 #include "s3d/robust/estimation_algorithm_traits.h"
 #include "s3d/robust/parameters.h"
 #include "s3d/robust/inliers.h"
+#include "s3d/robust/model_sampler.h"
+#include "s3d/robust/ransac.h"  // NotEnoughInliersFound
 #include "s3d/robust/trials.h"
 
+#include "s3d/concurrency/thread_pool.h"
 #include "s3d/utilities/containers.h"
 #include "s3d/utilities/rand.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <stdexcept>
@@ -19,15 +23,21 @@ namespace robust {
 /**
  * Robust estimation of a Model using random sampling
  * and an inlier/outlier classification strategy (RANSAC, LMedS...).
+ * Hypotheses are drawn by SamplerType: uniformly by default, ProsacSampler for ranked samples.
+ *
+ * The number of trials starts from the 50% outliers bound of LMedS and is lowered like RANSAC
+ * once the best model has more than half of the samples within params.distanceThreshold.
  */
-template<class ModelSolver, class DistanceFunction>
+template<class ModelSolver,
+         class DistanceFunction,
+         class SamplerType = ModelSampler<ModelSolver, DistanceFunction>>
 class Lmeds {
 public:
   // retrieve traits
   using SampleType = typename estimation_algorithm_traits<ModelSolver>::SampleType;
   using ModelType = typename estimation_algorithm_traits<ModelSolver>::ModelType;
   static constexpr auto MIN_NB_SAMPLES = estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES;
-  using Sampler = ModelSampler<ModelSolver, DistanceFunction>;
+  using Sampler = SamplerType;
 
   using Samples = std::vector<SampleType>;
 
@@ -37,41 +47,61 @@ public:
     assert(samples1.size() == samples2.size());
     assert(samples1.size() >= MIN_NB_SAMPLES);
 
-    modelSampler_ = std::make_unique<Sampler>(std::move(samples1), std::move(samples2));
+    modelSampler_ =
+        std::make_unique<Sampler>(std::move(samples1), std::move(samples2), params_.seed);
+    return estimate();
+  }
 
-    trials_ = std::make_unique<Trials>(modelSampler_->nbSamples(),
-                                       estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES,
-                                       computeNbTrials(),
-                                       params_);
-    inliers_ = std::make_unique<InliersLMedS>(modelSampler_->nbSamples(), params_.distanceThreshold);
+  // borrows samples already in the layout of DistanceSamples<DistanceFunction>
+  // (e.g. SampsonDistanceFunction::SoaView), they must outlive the estimator
+  template<class SamplesView>
+  ModelType operator()(const SamplesView& samples) {
+    assert(samples.size() >= MIN_NB_SAMPLES);
 
-    return runAlgorithm();
+    modelSampler_ = std::make_unique<Sampler>(samples, params_.seed);
+    return estimate();
   }
 
   std::pair<Samples, Samples> getBestInlierSamples() {
     return modelSampler_->getSamplesWhereTrue(bestInliers_);
   }
 
+  // indexes the samples given to operator(), to filter them without copies
+  const InlierMask& getBestInlierMask() const { return bestInliers_; }
+
 
   size_t getTotalNumberOfIterations() {
     return trials_ != nullptr ? trials_->currentNb() : 0;
   }
 
 private:
+  ModelType estimate() {
+    trials_ = std::make_unique<Trials>(modelSampler_->nbSamples(),
+                                       estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES,
+                                       computeNbTrials(),
+                                       params_);
+    inliers_ = std::make_unique<InliersLMedS>(modelSampler_->nbSamples(), params_.distanceThreshold);
+
+    return runAlgorithm();
+  }
+
   ModelType runAlgorithm() {
+    if (params_.nbThreads != 1) {
+      runTrialsInParallel();
+    }
     while (!trials_->reachedMaxNb()) {
       auto model = modelSampler_->sampleModel();
       inliers_->updateCurrent(modelSampler_->distances_);
       inliers_->updateBest();
       if (inliers_->wereLastBest()) {
         bestModel_ = model;
+        trials_->updateNb(static_cast<double>(countWithinThreshold(modelSampler_->distances_)));
       }
     }
 
     // find inliers from bestModel
-    DistanceFunction::ComputeDistance(modelSampler_->samples1_, modelSampler_->samples2_, bestModel_, &modelSampler_->distances_);
-    size_t nbInliers;
-    std::tie(bestInliers_, nbInliers) = inliers_->computeInliers(modelSampler_->distances_);
+    modelSampler_->distanceSamples().computeDistances(bestModel_, &modelSampler_->distances_);
+    size_t nbInliers = inliers_->computeInliers(modelSampler_->distances_, &bestInliers_);
 
     if (nbInliers < estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES) {
       throw NotEnoughInliersFound(MIN_NB_SAMPLES, nbInliers);
@@ -80,6 +110,76 @@ private:
     return bestModel_;
   }
 
+  // same as Ransac::runTrialsInParallel
+  void runTrialsInParallel() {
+    constexpr size_t nbHypothesesPerSlot = 8;
+    const size_t nbSlots =
+        params_.nbThreads == 0 ? ThreadPool::global().size() + 1 : params_.nbThreads;
+
+    struct Slot {
+      typename Sampler::Workspace workspace;
+      InliersLMedS inliers;
+      ModelType bestModel;
+      size_t bestNbWithinThreshold;
+    };
+    std::vector<Slot> slots;
+    slots.reserve(nbSlots);
+    for (size_t i = 0; i < nbSlots; ++i) {
+      slots.push_back({modelSampler_->createWorkspace(i),
+                       InliersLMedS(modelSampler_->nbSamples(), params_.distanceThreshold),
+                       ModelType{},
+                       0});
+    }
+
+    size_t nbRemaining;
+    while ((nbRemaining = trials_->remainingNb()) > 0) {
+      // the last batch is cut to the remaining number of trials
+      const size_t nbPerSlot = std::min(nbHypothesesPerSlot, (nbRemaining + nbSlots - 1) / nbSlots);
+      const size_t nbInBatch = std::min(nbRemaining, nbPerSlot * nbSlots);
+      ThreadPool::global().parallelFor(0, nbSlots, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          auto& slot = slots[i];
+          const size_t nbBefore = std::min(nbInBatch, i * nbPerSlot);
+          const size_t nbInSlot = std::min(nbPerSlot, nbInBatch - nbBefore);
+          for (size_t j = 0; j < nbInSlot; ++j) {
+            auto model = modelSampler_->sampleModel(&slot.workspace);
+            slot.inliers.updateCurrent(slot.workspace.distances);
+            slot.inliers.updateBest();
+            if (slot.inliers.wereLastBest()) {
+              slot.bestModel = model;
+              slot.bestNbWithinThreshold = countWithinThreshold(slot.workspace.distances);
+            }
+          }
+        }
+      }, nbSlots);
+      trials_->addNb(nbInBatch);
+
+      size_t bestNbWithinThreshold = 0;
+      for (const auto& slot : slots) {
+        bestNbWithinThreshold = std::max(bestNbWithinThreshold, slot.bestNbWithinThreshold);
+      }
+      trials_->updateNb(static_cast<double>(bestNbWithinThreshold));
+    }
+
+    // lowest median, first slot on ties
+    size_t winner = 0;
+    for (size_t i = 1; i < nbSlots; ++i) {
+      if (slots[i].inliers.getBestMedian() < slots[winner].inliers.getBestMedian()) {
+        winner = i;
+      }
+    }
+    bestModel_ = slots[winner].bestModel;
+    inliers_ = std::make_unique<InliersLMedS>(std::move(slots[winner].inliers));
+  }
+
+  size_t countWithinThreshold(const std::vector<double>& distances) const {
+    size_t nb = 0;
+    for (double distance : distances) {
+      nb += distance <= params_.distanceThreshold ? 1 : 0;
+    }
+    return nb;
+  }
+
   size_t computeNbTrials() {
     size_t nbTrials = log(1.0 - params_.confidence) / log(1.0 - pow(0.5, MIN_NB_SAMPLES));
     nbTrials += sqrt(1 - pow(0.5, 4)) / pow(0.5, 4); // + std of multiples
@@ -87,7 +187,7 @@ private:
   }
 
   Parameters params_;
-  std::vector<bool> bestInliers_{};
+  InlierMask bestInliers_{};
   ModelType bestModel_{};
   std::unique_ptr<Sampler> modelSampler_;
   std::unique_ptr<Trials> trials_{};
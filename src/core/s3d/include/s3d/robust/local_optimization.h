@@ -0,0 +1,135 @@
+#ifndef S3D_ROBUST_LOCAL_OPTIMIZATION_H
+#define S3D_ROBUST_LOCAL_OPTIMIZATION_H
+
+#include "s3d/robust/estimation_algorithm_traits.h"
+#include "s3d/robust/inlier_mask.h"
+#include "s3d/robust/inliers.h"
+
+#include "s3d/utilities/rand.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace s3d {
+namespace robust {
+
+/**
+ * Local optimization of a new best hypothesis (LO-RANSAC, Chum et al. 2003, Lebeda et al. 2012).
+ *
+ * An inner RANSAC draws non-minimal samples from the best inliers, each of its models is refined
+ * by least squares on its inliers, the threshold shrinking from THRESHOLD_MULTIPLIER times the
+ * distance threshold down to it (reweighting with 0/1 weights, solvers have no weighted form).
+ * Refined models are scored by Inliers like any other hypothesis.
+ */
+template<class ModelSolver, class DistanceFunction>
+class LocalOptimization {
+public:
+  using SampleType = typename estimation_algorithm_traits<ModelSolver>::SampleType;
+  using ModelType = typename estimation_algorithm_traits<ModelSolver>::ModelType;
+  using Samples = std::vector<SampleType>;
+
+  static constexpr size_t MIN_NB_SAMPLES = estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES;
+  static constexpr size_t NB_INNER_ITERATIONS = 10;
+  static constexpr size_t MAX_INNER_SAMPLE_SIZE = 7 * MIN_NB_SAMPLES;
+  static constexpr size_t NB_LEAST_SQUARES_ITERATIONS = 4;
+  static constexpr double THRESHOLD_MULTIPLIER = 3.0;
+
+  // seed < 0: random seed
+  LocalOptimization(size_t nbSamples, double distanceThreshold, int seed)
+    : distanceThreshold_{distanceThreshold}
+    , generator_(seed < 0 ? s3d::random_seed() : static_cast<uint64_t>(seed))
+    , distances_(nbSamples)
+    , mask_(nbSamples)
+  {
+    bestIndices_.reserve(nbSamples);
+    subset1_.reserve(nbSamples);
+    subset2_.reserve(nbSamples);
+  }
+
+  // refines the best hypothesis of inliers, returns true if a better one was found
+  template<class Sampler>
+  bool optimize(const Sampler& sampler, Inliers* inliers) {
+    bestIndices_.clear();
+    inliers->getBest().forEachSet(
+        [this](size_t i) { bestIndices_.push_back(static_cast<int>(i)); });
+    if (bestIndices_.size() <= MIN_NB_SAMPLES) {
+      return false;
+    }
+
+    const size_t sampleSize =
+        std::max(MIN_NB_SAMPLES, std::min(bestIndices_.size() / 2, MAX_INNER_SAMPLE_SIZE));
+    const int lastIdx = static_cast<int>(bestIndices_.size()) - 1;
+
+    bool improved = false;
+    for (size_t i = 0; i < NB_INNER_ITERATIONS; ++i) {
+      s3d::rand_n_unique_values(0, lastIdx, sampleSize, &generator_, &randPositions_);
+      subset1_.clear();
+      subset2_.clear();
+      for (int position : randPositions_) {
+        const auto j = static_cast<size_t>(bestIndices_[position]);
+        subset1_.push_back(sampler.distanceSamples().sample1(j));
+        subset2_.push_back(sampler.distanceSamples().sample2(j));
+      }
+
+      auto model = refine(sampler, ModelSolver::ComputeModel(subset1_, subset2_));
+      sampler.distanceSamples().computeDistances(model, &distances_);
+      inliers->updateCurrent(distances_);
+      inliers->updateBest();
+      improved |= inliers->wereLastBest();
+      ++nbRefinedModels_;
+    }
+    return improved;
+  }
+
+  size_t getNbRefinedModels() const { return nbRefinedModels_; }
+
+private:
+  template<class Sampler>
+  ModelType refine(const Sampler& sampler, ModelType model) {
+    for (size_t i = 0; i < NB_LEAST_SQUARES_ITERATIONS; ++i) {
+      const double step = static_cast<double>(i) / (NB_LEAST_SQUARES_ITERATIONS - 1);
+      const double threshold =
+          distanceThreshold_ * (THRESHOLD_MULTIPLIER - (THRESHOLD_MULTIPLIER - 1.0) * step);
+
+      sampler.distanceSamples().computeDistances(model, &distances_);
+      if (mask_.fill(distances_, threshold) <= MIN_NB_SAMPLES) {
+        break;
+      }
+      subset1_.clear();
+      subset2_.clear();
+      mask_.forEachSet([this, &sampler](size_t j) {
+        subset1_.push_back(sampler.distanceSamples().sample1(j));
+        subset2_.push_back(sampler.distanceSamples().sample2(j));
+      });
+      model = ModelSolver::ComputeModel(subset1_, subset2_);
+    }
+    return model;
+  }
+
+  double distanceThreshold_;
+  Xoshiro256 generator_;
+  std::vector<double> distances_;
+  InlierMask mask_;
+  std::vector<int> bestIndices_{};
+  std::vector<int> randPositions_{};
+  Samples subset1_{};
+  Samples subset2_{};
+  size_t nbRefinedModels_{0};
+};
+
+template<class ModelSolver, class DistanceFunction>
+constexpr size_t LocalOptimization<ModelSolver, DistanceFunction>::MIN_NB_SAMPLES;
+template<class ModelSolver, class DistanceFunction>
+constexpr size_t LocalOptimization<ModelSolver, DistanceFunction>::NB_INNER_ITERATIONS;
+template<class ModelSolver, class DistanceFunction>
+constexpr size_t LocalOptimization<ModelSolver, DistanceFunction>::MAX_INNER_SAMPLE_SIZE;
+template<class ModelSolver, class DistanceFunction>
+constexpr size_t LocalOptimization<ModelSolver, DistanceFunction>::NB_LEAST_SQUARES_ITERATIONS;
+template<class ModelSolver, class DistanceFunction>
+constexpr double LocalOptimization<ModelSolver, DistanceFunction>::THRESHOLD_MULTIPLIER;
+
+}  // namespace robust
+}  // namespace s3d
+
+#endif  // S3D_ROBUST_LOCAL_OPTIMIZATION_H
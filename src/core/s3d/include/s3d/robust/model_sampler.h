@@ -1,11 +1,19 @@
 #ifndef S3D_ROBUST_MODEL_SAMPLER_H
 #define S3D_ROBUST_MODEL_SAMPLER_H
 
+#include "s3d/robust/distance_samples.h"
 #include "s3d/robust/estimation_algorithm_traits.h"
+#include "s3d/robust/inlier_mask.h"
+#include "s3d/robust/trials.h"
 
 #include "s3d/utilities/containers.h"
 #include "s3d/utilities/rand.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
 namespace s3d {
 namespace robust {
 
@@ -15,45 +23,137 @@ struct ModelSampler {
   using ModelType = typename estimation_algorithm_traits<ModelSolver>::ModelType;
   using Samples = std::vector<SampleType>;
 
-  ModelSampler(Samples samples1, Samples samples2)
+  // per hypothesis memory, one per concurrent evaluation, nothing is allocated after creation
+  struct Workspace {
+    Workspace(size_t nbSamples, Xoshiro256 generator) : generator{generator} {
+      randIndices.reserve(MIN_NB_SAMPLES);
+      subset1.reserve(MIN_NB_SAMPLES);
+      subset2.reserve(MIN_NB_SAMPLES);
+      distances.resize(nbSamples);
+    }
+
+    Xoshiro256 generator;
+    std::vector<int> randIndices{};
+    Samples subset1{};
+    Samples subset2{};
+    std::vector<double> distances{};
+  };
+
+  // seed < 0: random seed
+  ModelSampler(Samples samples1, Samples samples2, int seed = -1)
     : samples1_{std::move(samples1)}
     , samples2_{std::move(samples2)}
+    , seed_{seed < 0 ? s3d::random_seed() : static_cast<uint64_t>(seed)}
+    , distanceSamples_{samples1_, samples2_}
+    , workspace_{distanceSamples_.size(), createGenerator(0)}
   {
-    distances_.resize(samples1_.size());
+    distances_.resize(distanceSamples_.size());
   }
 
+  // borrows samples already in the layout of DistanceSamples<DistanceFunction>
+  // (e.g. SampsonDistanceFunction::SoaView), they must outlive the sampler
+  template<class SamplesView>
+  ModelSampler(const SamplesView& samples, int seed)
+    : seed_{seed < 0 ? s3d::random_seed() : static_cast<uint64_t>(seed)}
+    , distanceSamples_{samples}
+    , workspace_{distanceSamples_.size(), createGenerator(0)}
+  {
+    distances_.resize(distanceSamples_.size());
+  }
+
+  // distanceSamples_ refers to the samples
+  ModelSampler(const ModelSampler&) = delete;
+  ModelSampler& operator=(const ModelSampler&) = delete;
+
   ModelType sampleModel() {
-    // todo: optimize by reusing memory
-    auto samples = getUniformSamples();
-    auto model = ModelSolver::ComputeModel(samples.first, samples.second);
-    DistanceFunction::ComputeDistance(samples1_, samples2_, model, &distances_);
-    assert(distances_.size() == samples1_.size());
+    auto model = sampleHypothesis();
+    distanceSamples_.computeDistances(model, &distances_);
+    assert(distances_.size() == distanceSamples_.size());
     return model;
   }
 
-  std::pair<Samples, Samples> getSamplesWhereTrue(const std::vector<bool> &flags) {
+  // model only, distances are left to the caller (e.g. verification with early bailout)
+  ModelType sampleHypothesis() { return computeModel(&workspace_); }
+
+  // distances are written in workspace->distances, safe to call concurrently on different workspaces
+  ModelType sampleModel(Workspace* workspace) const {
+    auto model = computeModel(workspace);
+    distanceSamples_.computeDistances(model, &workspace->distances);
+    return model;
+  }
+
+  // samples in the layout of the distance function, built once
+  const DistanceSamples<DistanceFunction>& distanceSamples() const { return distanceSamples_; }
+
+  // independent random stream for each value of stream, reproducible when a seed is given
+  Workspace createWorkspace(size_t stream) const {
+    return Workspace(distanceSamples_.size(), createGenerator(stream));
+  }
+
+  // called when the best inliers change, samplers with their own stopping rule tighten it further
+  void updateTrials(const InlierMask& /*bestInliers*/, size_t bestNb, Trials* trials) const {
+    trials->updateNb(static_cast<double>(bestNb));
+  }
+
+  std::pair<Samples, Samples> getSamplesWhereTrue(const InlierMask &flags) {
+    assert(flags.size() == distanceSamples_.size());
+    const size_t nbTrue = flags.count();
     Samples inliers1, inliers2;
-    s3d::copy_if_true(
-            std::begin(samples1_), std::end(samples1_), back_inserter(inliers1), flags);
-    s3d::copy_if_true(
-            std::begin(samples2_), std::end(samples2_), back_inserter(inliers2), flags);
+    inliers1.reserve(nbTrue);
+    inliers2.reserve(nbTrue);
+    flags.forEachSet([&](size_t i) {
+      inliers1.push_back(distanceSamples_.sample1(i));
+      inliers2.push_back(distanceSamples_.sample2(i));
+    });
     return {inliers1, inliers2};
   };
 
   std::pair<Samples, Samples> getUniformSamples() {
-    auto randIndices =
-            s3d::rand_n_unique_values(0, static_cast<int>(samples1_.size()) - 1,
-                                      estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES);
-    auto samples1 = s3d::values_from_indices(samples1_, randIndices);
-    auto samples2 = s3d::values_from_indices(samples2_, randIndices);
-    return {samples1, samples2};
+    sampleUniformly(&workspace_);
+    return {workspace_.subset1, workspace_.subset2};
   };
 
-  size_t nbSamples() { return samples1_.size(); }
+  size_t nbSamples() const { return distanceSamples_.size(); }
+
+  std::vector<double> distances_;
+
+protected:
+  static constexpr auto MIN_NB_SAMPLES = estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES;
+
+  // non-overlapping sequences of the same seed
+  Xoshiro256 createGenerator(size_t stream) const { return Xoshiro256(seed_, stream); }
+
+  // fills workspace subsets with the samples at workspace->randIndices
+  void fillSubsets(Workspace* workspace) const {
+    workspace->subset1.clear();
+    workspace->subset2.clear();
+    for (int i : workspace->randIndices) {
+      workspace->subset1.push_back(distanceSamples_.sample1(static_cast<size_t>(i)));
+      workspace->subset2.push_back(distanceSamples_.sample2(static_cast<size_t>(i)));
+    }
+  }
 
+private:
+
+  // fills workspace subsets
+  void sampleUniformly(Workspace* workspace) const {
+    s3d::rand_n_unique_values(0, static_cast<int>(nbSamples()) - 1, MIN_NB_SAMPLES,
+                              &workspace->generator, &workspace->randIndices);
+    fillSubsets(workspace);
+  }
+
+  ModelType computeModel(Workspace* workspace) const {
+    sampleUniformly(workspace);
+    return ModelSolver::ComputeModel(workspace->subset1, workspace->subset2);
+  }
+
+  // empty when the samples are borrowed
   Samples samples1_{};
   Samples samples2_{};
-  std::vector<double> distances_;
+
+  uint64_t seed_;
+  DistanceSamples<DistanceFunction> distanceSamples_;
+  Workspace workspace_;
 };
 
 } // namespace robust
@@ -6,10 +6,25 @@
 namespace s3d {
 namespace robust {
 
+// how hypotheses are compared: number of inliers (RANSAC) or truncated quadratic cost (MSAC)
+enum class Scoring { InlierCount, Msac };
+
 struct Parameters {
   size_t nbTrials{500};
   double distanceThreshold{0.01};
   double confidence{0.999};
+
+  // < 0: random seed, otherwise results are reproducible (for a given nbThreads)
+  int seed{-1};
+
+  // hypotheses evaluated concurrently by batches, 1: sequential, 0: all available threads
+  size_t nbThreads{1};
+
+  Scoring scoring{Scoring::InlierCount};
+
+  // each new best hypothesis is refined on its inliers (LO-RANSAC),
+  // ModelSolver must then fit more than a minimal sample
+  bool localOptimization{false};
 };
 
 } // namespace robust
@@ -0,0 +1,160 @@
+#ifndef S3D_ROBUST_PROSAC_SAMPLER_H
+#define S3D_ROBUST_PROSAC_SAMPLER_H
+
+#include "s3d/robust/model_sampler.h"
+
+#include <cmath>
+
+namespace s3d {
+namespace robust {
+
+/**
+ * PROSAC sampling (Chum & Matas, 2005): samples must be sorted by decreasing quality
+ * (e.g. MatchFinder::sortByQuality). Hypotheses are drawn from the n best samples, n growing
+ * with the number of hypotheses drawn until all samples are used, sampling is uniform from there.
+ *
+ * Drop-in replacement of ModelSampler: Ransac<Solver, Distance, ProsacSampler<Solver, Distance>>
+ */
+template<class ModelSolver, class DistanceFunction>
+struct ProsacSampler : ModelSampler<ModelSolver, DistanceFunction> {
+  using Base = ModelSampler<ModelSolver, DistanceFunction>;
+  using ModelType = typename Base::ModelType;
+  using Samples = typename Base::Samples;
+
+  // number of hypotheses after which sampling would be uniform for any number of samples
+  static constexpr double NB_HYPOTHESES_TO_UNIFORM = 200000.0;
+
+  struct Workspace : Base::Workspace {
+    Workspace(size_t nbSamples, Xoshiro256 generator)
+      : Base::Workspace(nbSamples, generator)
+      , nbSamples{nbSamples}
+    {
+      // expected number of hypotheses drawn only from the m best samples
+      for (size_t i = 0; i < MIN_NB_SAMPLES; ++i) {
+        expectedNb *= static_cast<double>(MIN_NB_SAMPLES - i) / static_cast<double>(nbSamples - i);
+      }
+    }
+
+    size_t nbSamples;
+    size_t nbHypotheses{0};
+    size_t subsetSize{MIN_NB_SAMPLES};
+    double expectedNb{NB_HYPOTHESES_TO_UNIFORM};
+    size_t growthNb{1};
+  };
+
+  ProsacSampler(Samples samples1, Samples samples2, int seed = -1)
+    : Base(std::move(samples1), std::move(samples2), seed)
+    , workspace_{createWorkspace(0)}
+  {}
+
+  // borrowed samples, see ModelSampler
+  template<class SamplesView>
+  ProsacSampler(const SamplesView& samples, int seed)
+    : Base(samples, seed)
+    , workspace_{createWorkspace(0)}
+  {}
+
+  ModelType sampleModel() {
+    auto model = sampleHypothesis();
+    this->distanceSamples().computeDistances(model, &this->distances_);
+    return model;
+  }
+
+  ModelType sampleHypothesis() { return computeModel(&workspace_); }
+
+  // distances are written in workspace->distances, safe to call concurrently on different workspaces
+  ModelType sampleModel(Workspace* workspace) const {
+    auto model = computeModel(workspace);
+    this->distanceSamples().computeDistances(model, &workspace->distances);
+    return model;
+  }
+
+  // PROSAC stopping rule: besides the usual bound on all samples, the bound from the inlier ratio
+  // of the n best ranked samples is used, for the n whose inliers are unlikely to be random
+  void updateTrials(const InlierMask& bestInliers, size_t bestNb, Trials* trials) const {
+    Base::updateTrials(bestInliers, bestNb, trials);
+
+    size_t nbInliersInSubset = 0;
+    for (size_t n = 1; n <= bestInliers.size(); ++n) {
+      if (bestInliers[n - 1]) {
+        ++nbInliersInSubset;
+      }
+      if (n >= MIN_TERMINATION_LENGTH && nbInliersInSubset >= minNbNonRandomInliers(n)) {
+        trials->updateNb(static_cast<double>(nbInliersInSubset), n);
+      }
+    }
+  }
+
+  // each workspace grows its own subset, streams of a parallel evaluation all start from the best
+  Workspace createWorkspace(size_t stream) const {
+    return Workspace(this->nbSamples(), this->createGenerator(stream));
+  }
+
+private:
+  static constexpr auto MIN_NB_SAMPLES = Base::MIN_NB_SAMPLES;
+  static constexpr size_t MIN_TERMINATION_LENGTH = 20;
+
+  // probability for an outlier to support a wrong model
+  static constexpr double BETA = 0.05;
+
+  // normal approximation of the binomial distribution of the support of a random model,
+  // which exceeds the returned number with probability 0.05
+  static size_t minNbNonRandomInliers(size_t subsetSize) {
+    constexpr double zScoreOneMinusPsi = 1.6449;
+    const double n = static_cast<double>(subsetSize - MIN_NB_SAMPLES);
+    const double mean = n * BETA;
+    const double sigma = std::sqrt(n * BETA * (1.0 - BETA));
+    return MIN_NB_SAMPLES + static_cast<size_t>(std::ceil(mean + zScoreOneMinusPsi * sigma));
+  }
+
+  // fills workspace subsets
+  void sampleProgressively(Workspace* workspace) const {
+    auto& w = *workspace;
+    ++w.nbHypotheses;
+
+    if (w.nbHypotheses > w.growthNb && w.subsetSize < w.nbSamples) {
+      const double n = static_cast<double>(w.subsetSize);
+      const double nextExpectedNb = w.expectedNb * (n + 1.0) / (n + 1.0 - MIN_NB_SAMPLES);
+      w.growthNb += static_cast<size_t>(std::ceil(nextExpectedNb - w.expectedNb));
+      w.expectedNb = nextExpectedNb;
+      ++w.subsetSize;
+    }
+
+    const int lastIdx = static_cast<int>(w.subsetSize) - 1;
+    if (w.growthNb < w.nbHypotheses) {
+      // whole subset reached: uniform over the n best
+      s3d::rand_n_unique_values(0, lastIdx, MIN_NB_SAMPLES, &w.generator, &w.randIndices);
+    } else {
+      // m - 1 from the n - 1 best, plus the n-th
+      if (lastIdx == MIN_NB_SAMPLES - 1) {
+        w.randIndices.clear();
+        for (int i = 0; i < lastIdx; ++i) {
+          w.randIndices.push_back(i);
+        }
+      } else {
+        s3d::rand_n_unique_values(0, lastIdx - 1, MIN_NB_SAMPLES - 1, &w.generator,
+                                  &w.randIndices);
+      }
+      w.randIndices.push_back(lastIdx);
+    }
+
+    this->fillSubsets(&w);
+  }
+
+  ModelType computeModel(Workspace* workspace) const {
+    sampleProgressively(workspace);
+    return ModelSolver::ComputeModel(workspace->subset1, workspace->subset2);
+  }
+
+  Workspace workspace_;
+};
+
+template<class ModelSolver, class DistanceFunction>
+constexpr double ProsacSampler<ModelSolver, DistanceFunction>::NB_HYPOTHESES_TO_UNIFORM;
+template<class ModelSolver, class DistanceFunction>
+constexpr size_t ProsacSampler<ModelSolver, DistanceFunction>::MIN_TERMINATION_LENGTH;
+
+} // namespace robust
+} // namespace s3d
+
+#endif //S3D_ROBUST_PROSAC_SAMPLER_H
@@ -4,13 +4,19 @@
 #include "s3d/robust/estimation_algorithm_traits.h"
 #include "s3d/robust/parameters.h"
 #include "s3d/robust/inliers.h"
+#include "s3d/robust/local_optimization.h"
 #include "s3d/robust/trials.h"
 
+#include "s3d/concurrency/thread_pool.h"
 #include "s3d/utilities/containers.h"
 #include "s3d/utilities/rand.h"
 #include "model_sampler.h"
+#include "verification.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 
@@ -28,15 +34,24 @@ public:
 /**
  * Robust estimation of a Model using random sampling
  * and an inlier/outlier classification strategy (RANSAC, LMedS...).
+ * Hypotheses are drawn by SamplerType: uniformly by default, ProsacSampler for ranked samples.
+ * They are checked by VerifierType: on all samples by default, SprtVerification to bail out early
+ * (sequential evaluation only, parallel batches verify every sample).
+ * Hypotheses are compared by params.scoring, each new best one is refined with
+ * params.localOptimization.
  */
-template<class ModelSolver, class DistanceFunction>
+template<class ModelSolver,
+         class DistanceFunction,
+         class SamplerType = ModelSampler<ModelSolver, DistanceFunction>,
+         class VerifierType = FullVerification<DistanceFunction>>
 class Ransac {
 public:
   // retrieve traits
   using SampleType = typename estimation_algorithm_traits<ModelSolver>::SampleType;
   using ModelType = typename estimation_algorithm_traits<ModelSolver>::ModelType;
   static constexpr auto MIN_NB_SAMPLES = estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES;
-  using Sampler = ModelSampler<ModelSolver, DistanceFunction>;
+  using Sampler = SamplerType;
+  using Verifier = VerifierType;
 
   using Samples = std::vector<SampleType>;
 
@@ -46,32 +61,84 @@ public:
     assert(samples1.size() == samples2.size());
     assert(samples1.size() >= MIN_NB_SAMPLES);
 
-    modelSampler_ = std::make_unique<Sampler>(std::move(samples1), std::move(samples2));
+    modelSampler_ =
+        std::make_unique<Sampler>(std::move(samples1), std::move(samples2), params_.seed);
+    return estimate();
+  }
 
-    trials_ = std::make_unique<Trials>(modelSampler_->nbSamples(),
-                                       estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES,
-                                       params_.nbTrials,
-                                       params_);
-    inliers_ = std::make_unique<Inliers>(modelSampler_->nbSamples(), params_.distanceThreshold);
+  // borrows samples already in the layout of DistanceSamples<DistanceFunction>
+  // (e.g. SampsonDistanceFunction::SoaView), they must outlive the estimator
+  template<class SamplesView>
+  ModelType operator()(const SamplesView& samples) {
+    assert(samples.size() >= MIN_NB_SAMPLES);
 
-    return runAlgorithm();
+    modelSampler_ = std::make_unique<Sampler>(samples, params_.seed);
+    return estimate();
   }
 
   std::pair<Samples, Samples> getBestInlierSamples() {
     return modelSampler_->getSamplesWhereTrue(inliers_->getBest());
   }
 
+  // indexes the samples given to operator(), to filter them without copies
+  const InlierMask& getBestInlierMask() const { return inliers_->getBest(); }
+
   size_t getTotalNumberOfIterations() {
     return trials_ != nullptr ? trials_->currentNb() : 0;
   }
 
+  size_t getNbDistanceEvaluations() {
+    return verifier_ != nullptr ? verifier_->getNbDistanceEvaluations() : 0;
+  }
+
+  size_t getNbLocallyOptimizedModels() {
+    return localOptimization_ != nullptr ? localOptimization_->getNbRefinedModels() : 0;
+  }
+
 private:
+  ModelType estimate() {
+    trials_ = std::make_unique<Trials>(modelSampler_->nbSamples(),
+                                       estimation_algorithm_traits<ModelSolver>::MIN_NB_SAMPLES,
+                                       params_.nbTrials,
+                                       params_);
+    inliers_ = createInliers();
+    verifier_ = std::make_unique<Verifier>(modelSampler_->nbSamples(), params_.distanceThreshold,
+                                           params_.seed);
+    localOptimization_.reset();
+    if (params_.localOptimization) {
+      localOptimization_ = std::make_unique<LocalOptimization<ModelSolver, DistanceFunction>>(
+          modelSampler_->nbSamples(), params_.distanceThreshold, params_.seed);
+    }
+
+    return runAlgorithm();
+  }
+
+  std::unique_ptr<Inliers> createInliers() const {
+    if (params_.scoring == Scoring::Msac) {
+      return std::make_unique<InliersMSAC>(modelSampler_->nbSamples(), params_.distanceThreshold);
+    }
+    return std::make_unique<Inliers>(modelSampler_->nbSamples(), params_.distanceThreshold);
+  }
+
   ModelType runAlgorithm() {
+    if (params_.nbThreads != 1) {
+      runTrialsInParallel();
+    }
     while (!trials_->reachedMaxNb()) {
-      modelSampler_->sampleModel();
+      auto model = modelSampler_->sampleHypothesis();
+      if (!verifier_->verify(modelSampler_->distanceSamples(), model, &modelSampler_->distances_)) {
+        continue;
+      }
       inliers_->updateCurrent(modelSampler_->distances_);
       inliers_->updateBest();
-      trials_->updateNb(inliers_->getCurrentNb());
+      if (inliers_->wereLastBest()) {
+        if (localOptimization_ != nullptr) {
+          localOptimization_->optimize(*modelSampler_, inliers_.get());
+        }
+        verifier_->onNewBest(inliers_->getBestNb());
+        trials_->setGoodModelAcceptance(verifier_->goodModelAcceptance());
+        modelSampler_->updateTrials(inliers_->getBest(), inliers_->getBestNb(), trials_.get());
+      }
     }
 
     if (inliers_->getBestNb() < MIN_NB_SAMPLES) {
@@ -81,10 +148,88 @@ private:
     return ModelSolver::ComputeModel(bestInlierPoints.first, bestInlierPoints.second);
   }
 
+  // batches of hypotheses are evaluated by slots, each with its own workspace and random stream,
+  // the trials bound is updated between batches with the best inlier count of all slots
+  void runTrialsInParallel() {
+    constexpr size_t nbHypothesesPerSlot = 8;
+    const size_t nbSlots =
+        params_.nbThreads == 0 ? ThreadPool::global().size() + 1 : params_.nbThreads;
+
+    struct Slot {
+      typename Sampler::Workspace workspace;
+      std::unique_ptr<Inliers> inliers;
+    };
+    std::vector<Slot> slots;
+    slots.reserve(nbSlots);
+    for (size_t i = 0; i < nbSlots; ++i) {
+      slots.push_back({modelSampler_->createWorkspace(i), createInliers()});
+    }
+
+    // best score, first slot on ties: same result for a given seed and number of slots
+    auto leadingSlot = [&slots, nbSlots] {
+      size_t leader = 0;
+      for (size_t i = 1; i < nbSlots; ++i) {
+        if (slots[i].inliers->getBestScore() > slots[leader].inliers->getBestScore()) {
+          leader = i;
+        }
+      }
+      return leader;
+    };
+
+    // when counting inliers, hypotheses with fewer inliers than the best so far cannot win,
+    // their mask is not kept
+    const bool skipFewerInliers = params_.scoring == Scoring::InlierCount;
+    std::atomic<size_t> bestNb{0};
+    double optimizedScore = std::numeric_limits<double>::lowest();
+
+    size_t nbRemaining;
+    while ((nbRemaining = trials_->remainingNb()) > 0) {
+      // the last batch is cut to the remaining number of trials
+      const size_t nbPerSlot = std::min(nbHypothesesPerSlot, (nbRemaining + nbSlots - 1) / nbSlots);
+      const size_t nbInBatch = std::min(nbRemaining, nbPerSlot * nbSlots);
+      ThreadPool::global().parallelFor(0, nbSlots, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          auto& slot = slots[i];
+          const size_t nbBefore = std::min(nbInBatch, i * nbPerSlot);
+          const size_t nbInSlot = std::min(nbPerSlot, nbInBatch - nbBefore);
+          for (size_t j = 0; j < nbInSlot; ++j) {
+            modelSampler_->sampleModel(&slot.workspace);
+            slot.inliers->updateCurrent(slot.workspace.distances);
+
+            size_t nb = slot.inliers->getCurrentNb();
+            size_t currentBest = bestNb.load(std::memory_order_relaxed);
+            if (skipFewerInliers && nb < currentBest) {
+              continue;
+            }
+            slot.inliers->updateBest();
+            while (nb > currentBest && !bestNb.compare_exchange_weak(currentBest, nb)) {
+            }
+          }
+        }
+      }, nbSlots);
+
+      trials_->addNb(nbInBatch);
+      auto& leader = *slots[leadingSlot()].inliers;
+      if (localOptimization_ != nullptr && leader.getBestScore() > optimizedScore) {
+        localOptimization_->optimize(*modelSampler_, &leader);
+        optimizedScore = leader.getBestScore();
+        size_t currentBest = bestNb.load();
+        while (leader.getBestNb() > currentBest &&
+               !bestNb.compare_exchange_weak(currentBest, leader.getBestNb())) {
+        }
+      }
+      modelSampler_->updateTrials(leader.getBest(), leader.getBestNb(), trials_.get());
+    }
+
+    inliers_ = std::move(slots[leadingSlot()].inliers);
+  }
+
   Parameters params_;
   std::unique_ptr<Sampler> modelSampler_{};
   std::unique_ptr<Trials> trials_{};
   std::unique_ptr<Inliers> inliers_{};
+  std::unique_ptr<Verifier> verifier_{};
+  std::unique_ptr<LocalOptimization<ModelSolver, DistanceFunction>> localOptimization_{};
 };
 
 }  // namespace robust
@@ -18,15 +18,29 @@ public:
 
   void updateNb(double currentNbInliers);
 
+  // bound from the inlier ratio among a subset of the points (e.g. PROSAC best ranked samples)
+  void updateNb(double nbInliersInSubset, size_t subsetSize);
+
   bool reachedMaxNb();
 
+  // probability that an all-inlier sample is kept by the hypothesis verification (e.g. SPRT),
+  // taken into account by the next updates of the bound
+  void setGoodModelAcceptance(double probability);
+
+  // batch evaluation: number of trials left, and trials done since last call
+  size_t remainingNb() const;
+  void addNb(size_t nbTrials);
+
   size_t currentNb();
 
 private:
+  void updateNbFromRatio(double ratioOfInliers);
+
   Parameters params_;
   size_t maxNb_{};
   size_t minNbSamples_{};
   size_t curNb_{0};
+  double goodModelAcceptance_{1.0};
 
   const double logOneMinusConf_;
   const double oneOverNbPts_;
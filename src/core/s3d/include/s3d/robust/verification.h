@@ -0,0 +1,189 @@
+#ifndef S3D_ROBUST_VERIFICATION_H
+#define S3D_ROBUST_VERIFICATION_H
+
+#include "s3d/robust/distance_samples.h"
+
+#include "s3d/utilities/rand.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace s3d {
+namespace robust {
+
+/**
+ * Hypothesis verification used by Ransac: every distance is computed.
+ */
+template<class DistanceFunction>
+class FullVerification {
+public:
+  using Samples = DistanceSamples<DistanceFunction>;
+
+  FullVerification(size_t /*nbSamples*/, double /*distanceThreshold*/, int /*seed*/) {}
+
+  // true when the hypothesis may be the best one, all distances are then computed
+  template<class ModelType>
+  bool verify(const Samples& samples, const ModelType& model, std::vector<double>* distances) {
+    samples.computeDistances(model, distances);
+    nbDistanceEvaluations_ += distances->size();
+    return true;
+  }
+
+  void onNewBest(size_t /*nbInliers*/) {}
+
+  double goodModelAcceptance() const { return 1.0; }
+
+  size_t getNbDistanceEvaluations() const { return nbDistanceEvaluations_; }
+
+private:
+  size_t nbDistanceEvaluations_{0};
+};
+
+/**
+ * Randomized verification with Wald's sequential probability ratio test
+ * (Chum & Matas, "Optimal Randomized RANSAC", 2008).
+ *
+ * Samples are checked by blocks of contiguous samples (SIMD friendly), blocks in random order
+ * starting from a random block for each hypothesis, and a hypothesis is rejected as soon as it is
+ * likely to be bad. epsilon (inlier ratio of a good model) follows the best model found, delta (inlier ratio
+ * of a bad model) is estimated from the rejected hypotheses.
+ *
+ * DistanceSamples<DistanceFunction> must compute distances on a range of samples.
+ */
+template<class DistanceFunction>
+class SprtVerification {
+public:
+  using Samples = DistanceSamples<DistanceFunction>;
+
+  static constexpr size_t BLOCK_SIZE = 8;
+
+  // cost of computing a model, in number of distance evaluations
+  static constexpr double MODEL_COST = 200.0;
+  static constexpr double INITIAL_EPSILON = 0.1;
+  static constexpr double INITIAL_DELTA = 0.01;
+
+  // seed < 0: random seed
+  SprtVerification(size_t nbSamples, double distanceThreshold, int seed)
+    : distanceThreshold_{distanceThreshold}
+    , nbSamples_{nbSamples}
+    , order_((nbSamples + BLOCK_SIZE - 1) / BLOCK_SIZE)
+    , generator_(seed < 0 ? s3d::random_seed() : static_cast<uint64_t>(seed))
+  {
+    std::iota(std::begin(order_), std::end(order_), size_t{0});
+    std::shuffle(std::begin(order_), std::end(order_), generator_);
+    updateTest();
+  }
+
+  // true when the hypothesis may be the best one, all distances are then computed
+  template<class ModelType>
+  bool verify(const Samples& samples, const ModelType& model, std::vector<double>* distances) {
+    double likelihoodRatio = 1.0;
+    size_t nbInliers = 0;
+    size_t nbTested = 0;
+    // the same prefix of blocks for every hypothesis would correlate their decisions
+    size_t next = generator_.bounded(order_.size());
+    for (size_t i = 0; i < order_.size(); ++i) {
+      const size_t block = order_[next];
+      next = next + 1 < order_.size() ? next + 1 : 0;
+      const size_t begin = block * BLOCK_SIZE;
+      const size_t end = std::min(begin + BLOCK_SIZE, nbSamples_);
+      samples.computeDistances(model, begin, end, distances);
+
+      for (size_t j = begin; j < end; ++j) {
+        const bool isInlier = (*distances)[j] <= distanceThreshold_;
+        nbInliers += isInlier ? 1 : 0;
+        likelihoodRatio *= isInlier ? inlierLikelihoodRatio_ : outlierLikelihoodRatio_;
+      }
+      nbTested += end - begin;
+
+      if (likelihoodRatio > decisionThreshold_) {
+        nbDistanceEvaluations_ += nbTested;
+        onRejected(nbInliers, nbTested);
+        return false;
+      }
+    }
+    nbDistanceEvaluations_ += nbSamples_;
+    return true;
+  }
+
+  void onNewBest(size_t nbInliers) {
+    epsilon_ = static_cast<double>(nbInliers) / static_cast<double>(nbSamples_);
+    updateTest();
+  }
+
+  // a good model passes the test with probability 1 - 1 / A
+  double goodModelAcceptance() const { return 1.0 - 1.0 / decisionThreshold_; }
+
+  size_t getNbDistanceEvaluations() const { return nbDistanceEvaluations_; }
+
+private:
+  void onRejected(size_t nbInliers, size_t nbTested) {
+    rejectedNbInliers_ += nbInliers;
+    rejectedNbTested_ += nbTested;
+
+    // the test is only redesigned when the estimate moved noticeably
+    constexpr size_t minNbTested = 100;
+    const double delta = static_cast<double>(rejectedNbInliers_) / rejectedNbTested_;
+    if (rejectedNbTested_ >= minNbTested && delta > 0.0 &&
+        std::abs(delta - delta_) > 0.1 * delta_) {
+      delta_ = delta;
+      updateTest();
+    }
+  }
+
+  // decision threshold A solves A = MODEL_COST * C + 1 + log(A), one model per sample
+  void updateTest() {
+    if (epsilon_ <= delta_) {
+      // cannot tell good models from bad ones, verify everything
+      decisionThreshold_ = std::numeric_limits<double>::infinity();
+      inlierLikelihoodRatio_ = 1.0;
+      outlierLikelihoodRatio_ = 1.0;
+      return;
+    }
+
+    const double c = (1.0 - delta_) * std::log((1.0 - delta_) / (1.0 - epsilon_)) +
+                     delta_ * std::log(delta_ / epsilon_);
+    const double k = MODEL_COST * c + 1.0;
+    double a = k;
+    for (int i = 0; i < 10; ++i) {
+      a = k + std::log(a);
+    }
+
+    decisionThreshold_ = a;
+    inlierLikelihoodRatio_ = delta_ / epsilon_;
+    outlierLikelihoodRatio_ = (1.0 - delta_) / (1.0 - epsilon_);
+  }
+
+  double distanceThreshold_;
+  size_t nbSamples_;
+  std::vector<size_t> order_;  // blocks
+  Xoshiro256 generator_;
+
+  double epsilon_{INITIAL_EPSILON};
+  double delta_{INITIAL_DELTA};
+  double decisionThreshold_{};
+  double inlierLikelihoodRatio_{};
+  double outlierLikelihoodRatio_{};
+
+  size_t rejectedNbInliers_{0};
+  size_t rejectedNbTested_{0};
+  size_t nbDistanceEvaluations_{0};
+};
+
+template<class DistanceFunction>
+constexpr size_t SprtVerification<DistanceFunction>::BLOCK_SIZE;
+template<class DistanceFunction>
+constexpr double SprtVerification<DistanceFunction>::MODEL_COST;
+template<class DistanceFunction>
+constexpr double SprtVerification<DistanceFunction>::INITIAL_EPSILON;
+template<class DistanceFunction>
+constexpr double SprtVerification<DistanceFunction>::INITIAL_DELTA;
+
+} // namespace robust
+} // namespace s3d
+
+#endif //S3D_ROBUST_VERIFICATION_H
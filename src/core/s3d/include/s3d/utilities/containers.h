@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <ostream>
 #include <vector>
 
@@ -15,21 +16,29 @@ bool contains(Container c, T t) {
 
 template <class InIt, class OutIt>
 void copy_if_true(InIt srcBegin, InIt srcEnd, OutIt dstBegin, const std::vector<bool>& flags) {
-  auto i = 0;
-  std::copy_if(
-      srcBegin, srcEnd, dstBegin, [&i, flags](typename InIt::value_type) { return flags[i++]; });
+  size_t i = 0;
+  std::copy_if(srcBegin, srcEnd, dstBegin,
+               [&i, &flags](const typename InIt::value_type&) { return flags[i++]; });
 }
 
+// no allocation once sample has enough capacity
 template <class T, class IndexType>
-std::vector<T> values_from_indices(std::vector<T> values, std::vector<IndexType> indices) {
-  std::vector<T> sample;
-  sample.reserve(indices.size());
-
+void values_from_indices(const std::vector<T>& values,
+                         const std::vector<IndexType>& indices,
+                         std::vector<T>* sample) {
+  sample->clear();
   for (auto i : indices) {
     assert(i < static_cast<IndexType>(values.size()));
-    sample.emplace_back(values[i]);
+    sample->push_back(values[i]);
   }
+};
 
+template <class T, class IndexType>
+std::vector<T> values_from_indices(const std::vector<T>& values,
+                                   const std::vector<IndexType>& indices) {
+  std::vector<T> sample;
+  sample.reserve(indices.size());
+  values_from_indices(values, indices, &sample);
   return sample;
 };
 
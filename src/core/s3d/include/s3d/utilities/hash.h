@@ -0,0 +1,43 @@
+#ifndef S3D_UTILITIES_HASH_H
+#define S3D_UTILITIES_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace s3d {
+
+// 64 bits mixing (splitmix64 finalizer)
+inline uint64_t hash_mix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ULL;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBULL;
+  value ^= value >> 31;
+  return value;
+}
+
+inline uint64_t hash_combine(uint64_t seed, uint64_t value) {
+  return hash_mix(seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2)));
+}
+
+// content hash for cache keys (not cryptographic), reads 8 bytes at a time
+inline uint64_t hash_bytes(const uint8_t* data, size_t size, uint64_t seed = 0) {
+  uint64_t hash = hash_combine(seed, size);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = hash_combine(hash, word);
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, size - i);
+    hash = hash_combine(hash, word);
+  }
+  return hash;
+}
+
+}  // namespace s3d
+
+#endif  // S3D_UTILITIES_HASH_H
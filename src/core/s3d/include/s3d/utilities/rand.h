@@ -4,6 +4,8 @@
 #include "s3d/utilities/containers.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <random>
 #include <vector>
 
@@ -11,32 +13,162 @@
 
 namespace s3d {
 
-// todo: naive implementation, could take infinite time
-// better implementation would be to shuffle then choose n first
-template <class SizeType>
-std::vector<int> rand_n_unique_values(int minVal, int maxVal, SizeType n, int seed) {
-  assert(minVal < maxVal);
+/*
+ * D. Blackman and S. Vigna (2018).
+ * "Scrambled linear pseudorandom number generators" (xoshiro256**).
+ *
+ * Fast generator with a 256 bits state, jump() advances it by 2^128 values, which gives
+ * non-overlapping streams for parallel workers. Same values on every platform.
+ */
+class Xoshiro256 {
+public:
+  using result_type = uint64_t;
 
-  std::mt19937 mt(seed);
-  std::uniform_int_distribution<int> dist(minVal, maxVal);
+  explicit Xoshiro256(uint64_t seed = 0) {
+    // state from splitmix64, never all zeros
+    for (auto& s : state_) {
+      seed += 0x9e3779b97f4a7c15ULL;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+      s = z ^ (z >> 31U);
+    }
+  }
 
-  std::vector<int> randValues;
-  randValues.reserve(n);
+  // stream-th independent sequence of seed
+  Xoshiro256(uint64_t seed, size_t stream) : Xoshiro256(seed) {
+    for (size_t i = 0; i < stream; ++i) {
+      jump();
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+    const uint64_t t = state_[1] << 17U;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = rotl(state_[3], 45);
+    return result;
+  }
 
-  for (auto i = 0ULL; i < n; ++i) {
-    auto randNb = dist(mt);
-    while (s3d::contains(randValues, randNb)) {
-      randNb = dist(mt);
+  // uniform in [0, range), range > 0 (D. Lemire, "Fast random integer generation in an interval")
+  uint64_t bounded(uint64_t range) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 m = static_cast<unsigned __int128>((*this)()) * range;
+    auto low = static_cast<uint64_t>(m);
+    if (low < range) {
+      const uint64_t threshold = (0 - range) % range;
+      while (low < threshold) {
+        m = static_cast<unsigned __int128>((*this)()) * range;
+        low = static_cast<uint64_t>(m);
+      }
     }
-    randValues.emplace_back(randNb);
+    return static_cast<uint64_t>(m >> 64U);
+#else
+    const uint64_t threshold = (0 - range) % range;
+    uint64_t x;
+    do {
+      x = (*this)();
+    } while (x < threshold);
+    return x % range;
+#endif
   }
+
+  // same as 2^128 calls
+  void jump() {
+    constexpr uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (uint64_t jump : JUMP) {
+      for (unsigned int b = 0; b < 64; ++b) {
+        if ((jump & (uint64_t{1} << b)) != 0) {
+          s0 ^= state_[0];
+          s1 ^= state_[1];
+          s2 ^= state_[2];
+          s3 ^= state_[3];
+        }
+        (*this)();
+      }
+    }
+    state_[0] = s0;
+    state_[1] = s1;
+    state_[2] = s2;
+    state_[3] = s3;
+  }
+
+private:
+  static uint64_t rotl(uint64_t x, unsigned int k) { return (x << k) | (x >> (64U - k)); }
+
+  uint64_t state_[4];
+};
+
+// 64 bits seed from the system entropy source
+inline uint64_t random_seed() {
+  std::random_device rd;
+  return (static_cast<uint64_t>(rd()) << 32U) ^ rd();
+}
+
+namespace detail {
+
+template <class Generator>
+int uniform_int(int minVal, int maxVal, Generator* generator) {
+  return std::uniform_int_distribution<int>(minVal, maxVal)(*generator);
+}
+
+inline int uniform_int(int minVal, int maxVal, Xoshiro256* generator) {
+  const auto range = static_cast<uint64_t>(static_cast<int64_t>(maxVal) - minVal + 1);
+  return minVal + static_cast<int>(generator->bounded(range));
+}
+
+}  // namespace detail
+
+// n distinct values of [minVal, maxVal] (R. Floyd's algorithm, n draws whatever the range)
+// no allocation once randValues has capacity n, generator is reused between calls
+template <class SizeType, class Generator>
+void rand_n_unique_values(int minVal,
+                          int maxVal,
+                          SizeType n,
+                          Generator* generator,
+                          std::vector<int>* randValues) {
+  assert(minVal <= maxVal);
+  const int nbValues = static_cast<int>(n);
+  assert(nbValues <= maxVal - minVal + 1);
+
+  randValues->clear();
+  for (int j = maxVal - nbValues + 1; j <= maxVal; ++j) {
+    const int randNb = detail::uniform_int(minVal, j, generator);
+    if (std::find(randValues->begin(), randValues->end(), randNb) != randValues->end()) {
+      randValues->push_back(j);
+    } else {
+      randValues->push_back(randNb);
+    }
+  }
+};
+
+template <class SizeType>
+std::vector<int> rand_n_unique_values(int minVal, int maxVal, SizeType n, int seed) {
+  Xoshiro256 generator(static_cast<uint64_t>(seed));
+
+  std::vector<int> randValues;
+  randValues.reserve(n);
+  rand_n_unique_values(minVal, maxVal, n, &generator, &randValues);
   return randValues;
 };
 
 template <class SizeType>
 std::vector<int> rand_n_unique_values(int minVal, int maxVal, SizeType n) {
-  std::random_device rd;
-  return rand_n_unique_values(minVal, maxVal, n, rd());
+  Xoshiro256 generator(random_seed());
+
+  std::vector<int> randValues;
+  randValues.reserve(n);
+  rand_n_unique_values(minVal, maxVal, n, &generator, &randValues);
+  return randValues;
 };
 
 }  // namespace s3d
@@ -2,50 +2,267 @@
 #define S3D_UTILITIES_STATS_H
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <vector>
 
 namespace s3d {
 
-// percentile in range [0.0f, 1.0f]
-//
-template <class T>
-T percentile(const std::vector<T>& values, float percentile) {
+namespace detail {
+
+// percentile as linear interpolation between the order statistics index and index + 1
+struct PercentileRank {
+  size_t index;
+  float remainder;
+  bool interpolate;
+};
+
+inline PercentileRank percentile_rank(size_t size, float percentile) {
   assert(percentile <= 1.0f);
   assert(percentile >= 0.0f);
+  assert(size > 0);
 
-  auto valuesCopy = values;  // todo : maybe rethink this quick change
-  std::sort(std::begin(valuesCopy), std::end(valuesCopy));
-
-  auto N = static_cast<float>(valuesCopy.size());
+  auto N = static_cast<float>(size);
   float x = percentile * (N - 1.0f) + 1.0f;
   float integral = std::floor(x);
   float remainder = x - std::floor(x);
 
-  int index = static_cast<int>(integral);
-
   constexpr auto PERCENTILE_EPS = 0.00001f;
-  if (remainder < PERCENTILE_EPS) {
-    return valuesCopy[index - 1];
+  return {static_cast<size_t>(integral) - 1, remainder, remainder >= PERCENTILE_EPS};
+}
+
+// [first, last) is partitioned around first + rank.index
+template <class RandomIt>
+typename std::iterator_traits<RandomIt>::value_type select_rank(RandomIt begin,
+                                                                RandomIt first,
+                                                                RandomIt last,
+                                                                const PercentileRank& rank) {
+  auto nth = begin + rank.index;
+  std::nth_element(first, nth, last);
+  if (!rank.interpolate) {
+    return *nth;
   }
+  // the next order statistic is the smallest value of the upper partition
+  auto next = *std::min_element(nth + 1, last);
+  return *nth + rank.remainder * (next - *nth);
+}
+
+}  // namespace detail
 
-  return valuesCopy[index - 1] + remainder * (valuesCopy[index] - valuesCopy[index - 1]);
+// percentile in range [0.0f, 1.0f], values are reordered (selection, no full sort)
+template <class RandomIt>
+typename std::iterator_traits<RandomIt>::value_type percentile_in_place(RandomIt first,
+                                                                        RandomIt last,
+                                                                        float percentile) {
+  auto rank = detail::percentile_rank(static_cast<size_t>(std::distance(first, last)), percentile);
+  return detail::select_rank(first, first, last, rank);
+}
+
+// percentile in range [0.0f, 1.0f]
+//
+template <class T>
+T percentile(const std::vector<T>& values, float percentile) {
+  auto valuesCopy = values;
+  return percentile_in_place(std::begin(valuesCopy), std::end(valuesCopy), percentile);
 }
 
+// values are reordered
+template <class RandomIt>
+typename std::iterator_traits<RandomIt>::value_type median_in_place(RandomIt first,
+                                                                    RandomIt last) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  assert(first != last);
+
+  const auto size = static_cast<size_t>(std::distance(first, last));
+  auto middle = first + size / 2;
+  std::nth_element(first, middle, last);
+  if (size % 2 != 0) {
+    return *middle;
+  }
+  return (*middle + *std::max_element(first, middle)) / T{2.0};
+}
 
 template <class T>
 T median(const std::vector<T>& values) {
   assert(values.size() > 0);
 
   std::vector<T> copy = values;
-  std::sort(std::begin(copy), std::end(copy));
-  const size_t size = copy.size();
+  return median_in_place(std::begin(copy), std::end(copy));
+}
 
-  if (size % 2 != 0) {
-    return copy[size/2];
+/**
+ * Several percentiles of the same values, with buffers reused between calls.
+ *
+ * Percentiles are selected in increasing order, each selection only partitions the values above
+ * the previous one (e.g. the 3rd then the 97th percentiles partition n then 0.97 n values), which
+ * saves the part below the previous percentile compared to independent selections.
+ */
+template <class T>
+class Quantiles {
+public:
+  // results[i] is the percentiles[i] of values (in range [0.0f, 1.0f])
+  void percentiles(const std::vector<T>& values,
+                   const std::vector<float>& percentiles,
+                   std::vector<T>* results) {
+    buffer_.assign(std::begin(values), std::end(values));
+    percentilesInPlace(&buffer_, percentiles, results);
   }
-  return (copy[size/2] + copy[size/2 - 1]) / T{2.0};
-}
+
+  T percentile(const std::vector<T>& values, float percentile) {
+    buffer_.assign(std::begin(values), std::end(values));
+    return percentile_in_place(std::begin(buffer_), std::end(buffer_), percentile);
+  }
+
+  T median(const std::vector<T>& values) {
+    buffer_.assign(std::begin(values), std::end(values));
+    return median_in_place(std::begin(buffer_), std::end(buffer_));
+  }
+
+  // values are reordered
+  void percentilesInPlace(std::vector<T>* values,
+                          const std::vector<float>& percentiles,
+                          std::vector<T>* results) {
+    ranks_.clear();
+    for (float percentile : percentiles) {
+      ranks_.push_back(detail::percentile_rank(values->size(), percentile));
+    }
+    order_.resize(percentiles.size());
+    std::iota(std::begin(order_), std::end(order_), size_t{0});
+    std::sort(std::begin(order_), std::end(order_),
+              [this](size_t a, size_t b) { return ranks_[a].index < ranks_[b].index; });
+
+    results->resize(percentiles.size());
+    auto begin = std::begin(*values);
+    auto first = begin;
+    for (size_t i : order_) {
+      (*results)[i] = detail::select_rank(begin, first, std::end(*values), ranks_[i]);
+      first = begin + ranks_[i].index;
+    }
+  }
+
+private:
+  std::vector<T> buffer_;
+  std::vector<detail::PercentileRank> ranks_;
+  std::vector<size_t> order_;
+};
+
+/*
+ * R. Jain and I. Chlamtac (1985).
+ * "The P2 algorithm for dynamic calculation of quantiles and histograms without storing
+ * observations". Communications of the ACM 28(10):1076–1085.
+ *
+ * Constant memory estimate of a percentile over a stream (e.g. a whole video).
+ */
+template <class T>
+class StreamingQuantile {
+public:
+  // percentile in range [0.0f, 1.0f]
+  explicit StreamingQuantile(float percentile) : percentile_{percentile} {
+    assert(percentile <= 1.0f);
+    assert(percentile >= 0.0f);
+    reset();
+  }
+
+  void update(T newValue) {
+    const double x = static_cast<double>(newValue);
+    if (count_ < NB_MARKERS) {
+      heights_[count_++] = x;
+      if (count_ == NB_MARKERS) {
+        std::sort(std::begin(heights_), std::end(heights_));
+      }
+      return;
+    }
+    ++count_;
+
+    // cell of the new value, extreme markers follow the min and max
+    size_t k;
+    if (x < heights_[0]) {
+      heights_[0] = x;
+      k = 0;
+    } else if (x >= heights_[NB_MARKERS - 1]) {
+      heights_[NB_MARKERS - 1] = x;
+      k = NB_MARKERS - 2;
+    } else {
+      k = 0;
+      while (x >= heights_[k + 1]) {
+        ++k;
+      }
+    }
+
+    for (size_t i = k + 1; i < NB_MARKERS; ++i) {
+      positions_[i] += 1.0;
+    }
+    for (size_t i = 0; i < NB_MARKERS; ++i) {
+      desiredPositions_[i] += increments_[i];
+    }
+
+    // inner markers are moved towards their desired position
+    for (size_t i = 1; i < NB_MARKERS - 1; ++i) {
+      const double d = desiredPositions_[i] - positions_[i];
+      if ((d >= 1.0 && positions_[i + 1] - positions_[i] > 1.0) ||
+          (d <= -1.0 && positions_[i - 1] - positions_[i] < -1.0)) {
+        const int sign = d > 0.0 ? 1 : -1;
+        const double height = parabolic(i, sign);
+        if (heights_[i - 1] < height && height < heights_[i + 1]) {
+          heights_[i] = height;
+        } else {
+          heights_[i] = linear(i, sign);
+        }
+        positions_[i] += sign;
+      }
+    }
+  }
+
+  void reset() {
+    count_ = 0;
+    const double p = percentile_;
+    positions_ = {{1.0, 2.0, 3.0, 4.0, 5.0}};
+    desiredPositions_ = {{1.0, 1.0 + 2.0 * p, 1.0 + 4.0 * p, 3.0 + 2.0 * p, 5.0}};
+    increments_ = {{0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0}};
+  }
+
+  // exact while less than 5 values were seen, only valid if count >= 1
+  T getQuantile() const {
+    if (count_ < NB_MARKERS) {
+      std::vector<double> values(std::begin(heights_), std::begin(heights_) + count_);
+      return static_cast<T>(percentile_in_place(std::begin(values), std::end(values), percentile_));
+    }
+    return static_cast<T>(heights_[2]);
+  }
+
+  size_t getCount() const { return count_; }
+
+private:
+  static constexpr size_t NB_MARKERS = 5;
+
+  double parabolic(size_t i, int sign) const {
+    const double d = sign;
+    const auto& n = positions_;
+    const auto& q = heights_;
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+                      ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                       (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+  }
+
+  double linear(size_t i, int sign) const {
+    const size_t j = sign > 0 ? i + 1 : i - 1;
+    return heights_[i] + sign * (heights_[j] - heights_[i]) / (positions_[j] - positions_[i]);
+  }
+
+  float percentile_;
+  size_t count_{0};
+  std::array<double, NB_MARKERS> heights_{};
+  std::array<double, NB_MARKERS> positions_{};
+  std::array<double, NB_MARKERS> desiredPositions_{};
+  std::array<double, NB_MARKERS> increments_{};
+};
+
+template <class T>
+constexpr size_t StreamingQuantile<T>::NB_MARKERS;
 
 /*
  * B. P. Welford (1962).
@@ -0,0 +1,126 @@
+#include "s3d/concurrency/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace s3d {
+
+ThreadPool::ThreadPool(size_t nbThreads) {
+  workers_.reserve(nbThreads);
+  for (size_t i = 0; i < nbThreads; ++i) {
+    workers_.emplace_back([this] { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+// static
+ThreadPool& ThreadPool::global() {
+  static ThreadPool pool;
+  return pool;
+}
+
+size_t ThreadPool::size() const noexcept {
+  return workers_.size();
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, const Range& body, size_t maxParallelism) {
+  if (end <= begin) {
+    return;
+  }
+
+  if (maxParallelism == 0) {
+    maxParallelism = size() + 1;
+  }
+  const size_t length = end - begin;
+  const size_t nbChunks = std::min(length, maxParallelism);
+  if (nbChunks <= 1 || workers_.empty()) {
+    body(begin, end);
+    return;
+  }
+
+  // chunks are claimed by whoever comes first, calling thread included
+  struct Job {
+    std::atomic<size_t> nextChunk{0};
+    size_t nbDone{0};
+    std::exception_ptr exception{};
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+  auto job = std::make_shared<Job>();
+
+  const size_t chunkSize = length / nbChunks;
+  const size_t remainder = length % nbChunks;
+  auto chunkBegin = [=](size_t chunk) {
+    return begin + chunk * chunkSize + std::min(chunk, remainder);
+  };
+
+  // body is only referenced while chunks remain, i.e. before this function returns
+  const Range* bodyPtr = &body;
+  auto work = [job, bodyPtr, nbChunks, chunkBegin] {
+    size_t chunk;
+    while ((chunk = job->nextChunk++) < nbChunks) {
+      std::exception_ptr exception{};
+      try {
+        (*bodyPtr)(chunkBegin(chunk), chunkBegin(chunk + 1));
+      } catch (...) {
+        exception = std::current_exception();
+      }
+
+      std::unique_lock<std::mutex> lock(job->mutex);
+      if (exception && !job->exception) {
+        job->exception = exception;
+      }
+      if (++job->nbDone == nbChunks) {
+        job->done.notify_one();
+      }
+    }
+  };
+
+  for (size_t i = 0; i < std::min(nbChunks - 1, size()); ++i) {
+    enqueue(work);
+  }
+  work();
+
+  std::unique_lock<std::mutex> lock(job->mutex);
+  job->done.wait(lock, [&job, nbChunks] { return job->nbDone == nbChunks; });
+  if (job->exception) {
+    std::rethrow_exception(job->exception);
+  }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    tasks_.push(std::move(task));
+  }
+  condition_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (stop_ && tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+}  // namespace s3d
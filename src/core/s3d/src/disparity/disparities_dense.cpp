@@ -0,0 +1,80 @@
+#include "s3d/disparity/disparities_dense.h"
+
+#include <utility>
+
+namespace s3d {
+
+namespace {
+
+// map values are leftCol - rightCol, disparities are rightCol - leftCol
+DisparityPoint pointAt(const Image<uint8_t>& disparityMap, int row, int col) {
+  return {{row, col}, {0, -static_cast<int>(disparityMap(row, col))}};
+}
+
+}  // namespace
+
+DisparitiesDense::DisparitiesDense(Image<uint8_t> disparityMap)
+    : disparityMap_{std::move(disparityMap)}, min_{{0, 0}, {0, 0}}, max_{{0, 0}, {0, 0}} {
+  // 0 is no disparity, the largest map value is the smallest disparity
+  int minRow = -1, minCol = -1, maxRow = -1, maxCol = -1;
+  uint8_t minValue = 0, maxValue = 0;
+  for (int row = 0; row < disparityMap_.height(); ++row) {
+    for (int col = 0; col < disparityMap_.width(); ++col) {
+      const uint8_t value = disparityMap_(row, col);
+      if (value == 0) {
+        continue;
+      }
+      if (minRow < 0 || value < minValue) {
+        minValue = value;
+        minRow = row;
+        minCol = col;
+      }
+      if (value > maxValue) {
+        maxValue = value;
+        maxRow = row;
+        maxCol = col;
+      }
+    }
+  }
+
+  if (maxRow < 0) {
+    return;
+  }
+  min_ = pointAt(disparityMap_, maxRow, maxCol);
+  max_ = pointAt(disparityMap_, minRow, minCol);
+}
+
+DisparitiesDense::DisparitiesDense(Image<uint8_t> disparityMap,
+                                   DisparityPoint min,
+                                   DisparityPoint max)
+    : disparityMap_{std::move(disparityMap)}, min_{min}, max_{max} {}
+
+gsl::owner<DisparitiesDense*> DisparitiesDense::clone() const {
+  return new DisparitiesDense(disparityMap_, min_, max_);
+}
+
+const Image<uint8_t>& DisparitiesDense::getDisparityMap() const {
+  return disparityMap_;
+}
+
+std::vector<DisparityPoint> DisparitiesDense::getDisparities() const {
+  std::vector<DisparityPoint> disparities;
+  for (int row = 0; row < disparityMap_.height(); ++row) {
+    for (int col = 0; col < disparityMap_.width(); ++col) {
+      if (disparityMap_(row, col) != 0) {
+        disparities.push_back(pointAt(disparityMap_, row, col));
+      }
+    }
+  }
+  return disparities;
+}
+
+DisparityPoint DisparitiesDense::min() const {
+  return min_;
+}
+
+DisparityPoint DisparitiesDense::max() const {
+  return max_;
+}
+
+}  // namespace s3d
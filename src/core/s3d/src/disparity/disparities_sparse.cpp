@@ -0,0 +1,47 @@
+#include "s3d/disparity/disparities_sparse.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace s3d {
+
+DisparitiesSparse::DisparitiesSparse(std::vector<DisparityPoint> disparities, Size imageSize)
+    : disparities_{std::move(disparities)}, disparityMap_(imageSize, uint8_t{0}) {
+  for (const auto& d : disparities_) {
+    if (0 <= d.leftPos.row && d.leftPos.row < disparityMap_.height() && 0 <= d.leftPos.col &&
+        d.leftPos.col < disparityMap_.width()) {
+      disparityMap_(d.leftPos.row, d.leftPos.col) =
+          static_cast<uint8_t>(std::min(std::max(-d.disparity.col, 0), 255));
+    }
+  }
+}
+
+gsl::owner<DisparitiesSparse*> DisparitiesSparse::clone() const {
+  return new DisparitiesSparse(disparities_, Size(disparityMap_.width(), disparityMap_.height()));
+}
+
+const Image<uint8_t>& DisparitiesSparse::getDisparityMap() const {
+  return disparityMap_;
+}
+
+std::vector<DisparityPoint> DisparitiesSparse::getDisparities() const {
+  return disparities_;
+}
+
+DisparityPoint DisparitiesSparse::min() const {
+  auto it = std::min_element(std::begin(disparities_), std::end(disparities_),
+                             [](const DisparityPoint& a, const DisparityPoint& b) {
+                               return a.disparity.col < b.disparity.col;
+                             });
+  return it != std::end(disparities_) ? *it : DisparityPoint{{0, 0}, {0, 0}};
+}
+
+DisparityPoint DisparitiesSparse::max() const {
+  auto it = std::max_element(std::begin(disparities_), std::end(disparities_),
+                             [](const DisparityPoint& a, const DisparityPoint& b) {
+                               return a.disparity.col < b.disparity.col;
+                             });
+  return it != std::end(disparities_) ? *it : DisparityPoint{{0, 0}, {0, 0}};
+}
+
+}  // namespace s3d
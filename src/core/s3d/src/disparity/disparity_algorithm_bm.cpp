@@ -0,0 +1,120 @@
+#include "s3d/disparity/disparity_algorithm_bm.h"
+
+#include "s3d/concurrency/thread_pool.h"
+#include "s3d/disparity/disparities_dense.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+
+namespace s3d {
+
+DisparityAlgorithmBM::DisparityAlgorithmBM(const Parameters& params) : params_{params} {
+  assert(0 < params.nbDisparities && params.nbDisparities <= 256);
+  assert(params.blockSize % 2 == 1 && params.blockSize < 256);
+}
+
+void DisparityAlgorithmBM::setNumberOfThreads(size_t nbThreads) {
+  nbThreads_ = nbThreads;
+}
+
+std::unique_ptr<Disparities> DisparityAlgorithmBM::ComputeDisparities(
+    const Image<uint8_t>& leftImg,
+    const Image<uint8_t>& rightImg) {
+  assert(leftImg.width() == rightImg.width() && leftImg.height() == rightImg.height());
+
+  Image<uint8_t> disparityMap(Size(leftImg.width(), leftImg.height()), uint8_t{0});
+  ThreadPool::global().parallelFor(
+      0, leftImg.height(),
+      [this, &leftImg, &rightImg, &disparityMap](size_t begin, size_t end) {
+        matchRows(leftImg, rightImg, static_cast<int>(begin), static_cast<int>(end),
+                  &disparityMap);
+      },
+      nbThreads_);
+
+  return std::make_unique<DisparitiesDense>(std::move(disparityMap));
+}
+
+void DisparityAlgorithmBM::matchRows(const Image<uint8_t>& leftImg,
+                                     const Image<uint8_t>& rightImg,
+                                     int firstRow,
+                                     int lastRow,
+                                     Image<uint8_t>* disparityMap) const {
+  const int width = leftImg.width();
+  const int height = leftImg.height();
+  const int nbDisparities = params_.nbDisparities;
+  const int radius = params_.blockSize / 2;
+  auto clampRow = [height](int y) { return std::min(std::max(y, 0), height - 1); };
+  auto clampCol = [width](int x) { return std::min(std::max(x, 0), width - 1); };
+
+  // columnSums[x * nbDisparities + d]: SAD of the block column at x, borders replicated,
+  // disparities pointing outside of the right image keep the max cost
+  std::vector<uint16_t> columnSums(static_cast<size_t>(width) * nbDisparities);
+  for (int x = 0; x < width; ++x) {
+    uint16_t* sums = columnSums.data() + static_cast<size_t>(x) * nbDisparities;
+    std::fill(sums, sums + nbDisparities, static_cast<uint16_t>(params_.blockSize * 255));
+    std::fill(sums, sums + std::min(x + 1, nbDisparities), uint16_t{0});
+  }
+
+  auto addRow = [&](int y, bool subtract) {
+    const uint8_t* left = leftImg.data() + static_cast<size_t>(y) * width;
+    const uint8_t* right = rightImg.data() + static_cast<size_t>(y) * width;
+    for (int x = 0; x < width; ++x) {
+      uint16_t* sums = columnSums.data() + static_cast<size_t>(x) * nbDisparities;
+      const int l = left[x];
+      const int nbValid = std::min(x + 1, nbDisparities);
+      for (int d = 0; d < nbValid; ++d) {
+        const auto difference = static_cast<uint16_t>(std::abs(l - right[x - d]));
+        sums[d] = subtract ? static_cast<uint16_t>(sums[d] - difference)
+                           : static_cast<uint16_t>(sums[d] + difference);
+      }
+    }
+  };
+
+  std::vector<uint32_t> blockSums(nbDisparities);
+  auto addColumn = [&](int x, bool subtract) {
+    const uint16_t* sums = columnSums.data() + static_cast<size_t>(clampCol(x)) * nbDisparities;
+    for (int d = 0; d < nbDisparities; ++d) {
+      blockSums[d] = subtract ? blockSums[d] - sums[d] : blockSums[d] + sums[d];
+    }
+  };
+
+  for (int y = firstRow - radius; y <= firstRow + radius; ++y) {
+    addRow(clampRow(y), false);
+  }
+
+  for (int y = firstRow; y < lastRow; ++y) {
+    if (y > firstRow) {
+      addRow(clampRow(y + radius), false);
+      addRow(clampRow(y - radius - 1), true);
+    }
+
+    std::fill(std::begin(blockSums), std::end(blockSums), 0U);
+    for (int x = -radius; x <= radius; ++x) {
+      addColumn(x, false);
+    }
+
+    for (int x = 0; x < width; ++x) {
+      if (x > 0) {
+        addColumn(x + radius, false);
+        addColumn(x - radius - 1, true);
+      }
+
+      const auto bestIt = std::min_element(std::begin(blockSums), std::end(blockSums));
+      const auto best = static_cast<int>(bestIt - std::begin(blockSums));
+      uint32_t secondBest = std::numeric_limits<uint32_t>::max();
+      for (int d = 0; d < nbDisparities; ++d) {
+        if (std::abs(d - best) > 1) {
+          secondBest = std::min(secondBest, blockSums[d]);
+        }
+      }
+
+      const bool unique = static_cast<uint64_t>(secondBest) * (100 - params_.uniquenessRatio) >
+                          static_cast<uint64_t>(*bestIt) * 100;
+      (*disparityMap)(y, x) = unique ? static_cast<uint8_t>(best) : uint8_t{0};
+    }
+  }
+}
+
+}  // namespace s3d
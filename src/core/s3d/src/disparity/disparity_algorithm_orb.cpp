@@ -0,0 +1,48 @@
+#include "s3d/disparity/disparity_algorithm_orb.h"
+
+#include "s3d/disparity/disparities_sparse.h"
+
+#include <cmath>
+
+namespace s3d {
+
+constexpr float DisparityAlgorithmORB::MAX_DISTANCE_RATIO;
+
+DisparityAlgorithmORB::DisparityAlgorithmORB(const OrbExtractor::Parameters& params)
+    : extractor_{params} {}
+
+void DisparityAlgorithmORB::setNumberOfThreads(size_t nbThreads) {
+  extractor_.setNumberOfThreads(nbThreads);
+  matcher_.setNumberOfThreads(nbThreads);
+}
+
+std::unique_ptr<Disparities> DisparityAlgorithmORB::ComputeDisparities(
+    const Image<uint8_t>& leftImg,
+    const Image<uint8_t>& rightImg) {
+  extractor_.detectAndCompute(leftImg, &keypointsLeft_, &descriptorsLeft_);
+  extractor_.detectAndCompute(rightImg, &keypointsRight_, &descriptorsRight_);
+
+  const auto matches = matcher_.knnMatch(descriptorsLeft_.data(), keypointsLeft_.size(),
+                                         descriptorsRight_.data(), keypointsRight_.size());
+
+  std::vector<DisparityPoint> disparityPoints;
+  for (size_t i = 0; i < matches.size(); ++i) {
+    const auto& match = matches[i];
+    if (match.secondTrainIdx < 0 ||
+        match.distance >= MAX_DISTANCE_RATIO * static_cast<float>(match.secondDistance)) {
+      continue;
+    }
+
+    const auto& left = keypointsLeft_[i];
+    const auto& right = keypointsRight_[match.trainIdx];
+    const PixelPos leftPos{static_cast<int>(left.y), static_cast<int>(left.x)};
+    disparityPoints.emplace_back(
+        leftPos, PixelPos{static_cast<int>(right.y) - leftPos.row,
+                          static_cast<int>(right.x) - leftPos.col});
+  }
+
+  return std::make_unique<DisparitiesSparse>(std::move(disparityPoints),
+                                             Size(leftImg.width(), leftImg.height()));
+}
+
+}  // namespace s3d
@@ -0,0 +1,408 @@
+#include "s3d/disparity/disparity_analyzer_sgm.h"
+
+#include "s3d/concurrency/thread_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__POPCNT__)
+#include <nmmintrin.h>
+#endif
+
+namespace s3d {
+
+namespace {
+
+constexpr int CENSUS_HALF_WIDTH = 4;
+constexpr int CENSUS_HALF_HEIGHT = 3;
+
+// cost of disparities pointing outside of the right image
+constexpr uint8_t MAX_COST = (2 * CENSUS_HALF_WIDTH + 1) * (2 * CENSUS_HALF_HEIGHT + 1) - 1;
+
+// previous path costs outside of the disparity range
+constexpr uint16_t PATH_SENTINEL = std::numeric_limits<uint16_t>::max();
+
+inline uint8_t hammingDistance(uint64_t a, uint64_t b) {
+#if defined(__AVX2__) || defined(__POPCNT__)
+  return static_cast<uint8_t>(_mm_popcnt_u64(a ^ b));
+#elif defined(__GNUC__)
+  return static_cast<uint8_t>(__builtin_popcountll(a ^ b));
+#else
+  uint64_t x = a ^ b;
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<uint8_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * One step of a scanline: for each disparity d
+ * L(d) = C(d) + min(Lp(d), Lp(d - 1) + P1, Lp(d + 1) + P1, min(Lp) + P2) - min(Lp)
+ *
+ * previous[-1] and previous[nbDisparities] are PATH_SENTINEL, current has the same layout.
+ * L is written to current and added to sum (or copied when !accumulate), returns min(L).
+ */
+inline uint16_t aggregateStep(const uint8_t* costs,
+                              const uint16_t* previous,
+                              uint16_t minPrevious,
+                              uint16_t p1,
+                              uint16_t p2,
+                              int nbDisparities,
+                              bool accumulate,
+                              uint16_t* current,
+                              uint16_t* sum) {
+  const auto maxJump = static_cast<uint16_t>(minPrevious + p2);
+#if defined(__AVX2__)
+  const __m256i vP1 = _mm256_set1_epi16(static_cast<int16_t>(p1));
+  const __m256i vMaxJump = _mm256_set1_epi16(static_cast<int16_t>(maxJump));
+  const __m256i vMinPrevious = _mm256_set1_epi16(static_cast<int16_t>(minPrevious));
+  __m256i vMinCurrent = _mm256_set1_epi16(static_cast<int16_t>(PATH_SENTINEL));
+  for (int d = 0; d < nbDisparities; d += 16) {
+    const __m256i c =
+        _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(costs + d)));
+    __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous + d));
+    m = _mm256_min_epu16(m, _mm256_adds_epu16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous + d - 1)), vP1));
+    m = _mm256_min_epu16(m, _mm256_adds_epu16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous + d + 1)), vP1));
+    m = _mm256_min_epu16(m, vMaxJump);
+    const __m256i l = _mm256_add_epi16(c, _mm256_sub_epi16(m, vMinPrevious));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(current + d), l);
+    auto* s = reinterpret_cast<__m256i*>(sum + d);
+    _mm256_storeu_si256(s, accumulate ? _mm256_add_epi16(_mm256_loadu_si256(s), l) : l);
+    vMinCurrent = _mm256_min_epu16(vMinCurrent, l);
+  }
+  const __m128i minHalves =
+      _mm_min_epu16(_mm256_castsi256_si128(vMinCurrent), _mm256_extracti128_si256(vMinCurrent, 1));
+  return static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(minHalves)));
+#else
+  uint16_t minCurrent = PATH_SENTINEL;
+  for (int d = 0; d < nbDisparities; ++d) {
+    const auto smallJump = static_cast<uint16_t>(
+        std::min<int>(PATH_SENTINEL, std::min(previous[d - 1], previous[d + 1]) + p1));
+    const uint16_t m = std::min(std::min(previous[d], smallJump), maxJump);
+    const auto l = static_cast<uint16_t>(costs[d] + m - minPrevious);
+
+    current[d] = l;
+    sum[d] = accumulate ? static_cast<uint16_t>(sum[d] + l) : l;
+    minCurrent = std::min(minCurrent, l);
+  }
+  return minCurrent;
+#endif
+}
+
+// min of costs[begin, end), PATH_SENTINEL when empty (vectorized)
+inline uint16_t minCost(const uint16_t* costs, int begin, int end) {
+  uint16_t min = PATH_SENTINEL;
+  for (int d = begin; d < end; ++d) {
+    min = std::min(min, costs[d]);
+  }
+  return min;
+}
+
+// path costs of one scanline position, with sentinels around the disparities
+class PathCosts {
+ public:
+  explicit PathCosts(int nbDisparities)
+      : stride_{static_cast<size_t>(nbDisparities) + 2}, values_(stride_, PATH_SENTINEL) {
+    reset();
+  }
+
+  // start of a scanline: L = C
+  void reset() {
+    std::fill(std::begin(values_) + 1, std::end(values_) - 1, uint16_t{0});
+    min_ = 0;
+  }
+
+  uint16_t* data() { return values_.data() + 1; }
+  uint16_t getMin() const { return min_; }
+  void setMin(uint16_t min) { min_ = min; }
+
+ private:
+  size_t stride_;
+  std::vector<uint16_t> values_;
+  uint16_t min_{0};
+};
+
+}  // namespace
+
+DisparityAnalyzerSGM::DisparityAnalyzerSGM() = default;
+
+DisparityAnalyzerSGM::DisparityAnalyzerSGM(const Parameters& params) {
+  setParameters(params);
+}
+
+gsl::owner<DisparityAnalyzerSGM*> DisparityAnalyzerSGM::clone() const {
+  auto* analyzer = new DisparityAnalyzerSGM(params_);
+  analyzer->setNumberOfThreads(nbThreads_);
+  return analyzer;
+}
+
+void DisparityAnalyzerSGM::setParameters(const Parameters& params) {
+  assert(params.nbDisparities > 0 && params.nbDisparities % 16 == 0);
+  params_ = params;
+}
+
+const DisparityAnalyzerSGM::Parameters& DisparityAnalyzerSGM::getParameters() const {
+  return params_;
+}
+
+void DisparityAnalyzerSGM::setNumberOfThreads(size_t nbThreads) {
+  nbThreads_ = nbThreads;
+}
+
+bool DisparityAnalyzerSGM::analyze(const Image<uint8_t>& leftImage,
+                                   const Image<uint8_t>& rightImage) {
+  assert(leftImage.width() == rightImage.width() && leftImage.height() == rightImage.height());
+  width_ = leftImage.width();
+  height_ = leftImage.height();
+  if (width_ == 0 || height_ == 0) {
+    clearStatistics();
+    return false;
+  }
+
+  const auto volumeSize = static_cast<size_t>(width_) * height_ * params_.nbDisparities;
+  costs_.resize(volumeSize);
+  aggregatedCosts_.resize(volumeSize);
+
+  computeCensus(leftImage, &censusLeft_);
+  computeCensus(rightImage, &censusRight_);
+  computeCosts();
+  aggregateHorizontal();
+  aggregateVertical();
+  computeDisparityMap();
+  computeStatistics();
+
+  return !results.disparitiesPercent.empty();
+}
+
+const std::vector<float>& DisparityAnalyzerSGM::getDisparitiesPercent() const {
+  return results.disparitiesPercent;
+}
+
+const std::vector<Eigen::Vector2f>& DisparityAnalyzerSGM::getFeaturePointsLeft() const {
+  return noFeaturePoints_;
+}
+
+const std::vector<Eigen::Vector2f>& DisparityAnalyzerSGM::getFeaturePointsRight() const {
+  return noFeaturePoints_;
+}
+
+void DisparityAnalyzerSGM::computeCensus(const Image<uint8_t>& image,
+                                         std::vector<uint64_t>* census) const {
+  census->resize(static_cast<size_t>(width_) * height_);
+  ThreadPool::global().parallelFor(0, height_, [this, &image, census](size_t begin, size_t end) {
+    // rows with replicated borders, each comparison is a pass over the row (vectorized)
+    const int paddedWidth = width_ + 2 * CENSUS_HALF_WIDTH;
+    std::vector<uint8_t> rows(static_cast<size_t>(2 * CENSUS_HALF_HEIGHT + 1) * paddedWidth);
+    for (auto y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+      for (int dy = -CENSUS_HALF_HEIGHT; dy <= CENSUS_HALF_HEIGHT; ++dy) {
+        const uint8_t* src = image.data() + std::min(std::max(y + dy, 0), height_ - 1) * width_;
+        uint8_t* row = rows.data() + (dy + CENSUS_HALF_HEIGHT) * paddedWidth;
+        std::fill(row, row + CENSUS_HALF_WIDTH, src[0]);
+        std::copy(src, src + width_, row + CENSUS_HALF_WIDTH);
+        std::fill(row + CENSUS_HALF_WIDTH + width_, row + paddedWidth, src[width_ - 1]);
+      }
+
+      const uint8_t* center = image.data() + y * width_;
+      uint64_t* bits = census->data() + static_cast<size_t>(y) * width_;
+      std::fill(bits, bits + width_, uint64_t{0});
+      for (int dy = -CENSUS_HALF_HEIGHT; dy <= CENSUS_HALF_HEIGHT; ++dy) {
+        for (int dx = -CENSUS_HALF_WIDTH; dx <= CENSUS_HALF_WIDTH; ++dx) {
+          if (dx == 0 && dy == 0) {
+            continue;
+          }
+          const uint8_t* neighbours =
+              rows.data() + (dy + CENSUS_HALF_HEIGHT) * paddedWidth + CENSUS_HALF_WIDTH + dx;
+          for (int x = 0; x < width_; ++x) {
+            bits[x] = (bits[x] << 1U) | (neighbours[x] < center[x] ? 1U : 0U);
+          }
+        }
+      }
+    }
+  }, nbThreads_);
+}
+
+void DisparityAnalyzerSGM::computeCosts() {
+  const int nbDisparities = params_.nbDisparities;
+  ThreadPool::global().parallelFor(0, height_, [this, nbDisparities](size_t begin, size_t end) {
+    for (auto y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+      const uint64_t* left = censusLeft_.data() + static_cast<size_t>(y) * width_;
+      const uint64_t* right = censusRight_.data() + static_cast<size_t>(y) * width_;
+      uint8_t* costs = costs_.data() + static_cast<size_t>(y) * width_ * nbDisparities;
+      for (int x = 0; x < width_; ++x, costs += nbDisparities) {
+        // disparities of [first, last) point inside of the right image
+        const int xRight = x + params_.minDisparity;
+        const int first = std::min(std::max(-xRight, 0), nbDisparities);
+        const int last = std::max(std::min(width_ - xRight, nbDisparities), first);
+        std::fill(costs, costs + first, MAX_COST);
+        for (int d = first; d < last; ++d) {
+          costs[d] = hammingDistance(left[x], right[xRight + d]);
+        }
+        std::fill(costs + last, costs + nbDisparities, MAX_COST);
+      }
+    }
+  }, nbThreads_);
+}
+
+// left to right and right to left, rows are independent
+void DisparityAnalyzerSGM::aggregateHorizontal() {
+  const int nbDisparities = params_.nbDisparities;
+  ThreadPool::global().parallelFor(0, height_, [this, nbDisparities](size_t begin, size_t end) {
+    PathCosts previous(nbDisparities), current(nbDisparities);
+    const size_t pixelStride = nbDisparities;
+    for (auto y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+      const size_t rowOffset = static_cast<size_t>(y) * width_ * pixelStride;
+      const uint8_t* costs = costs_.data() + rowOffset;
+      uint16_t* sums = aggregatedCosts_.data() + rowOffset;
+
+      previous.reset();
+      for (int x = 0; x < width_; ++x) {
+        current.setMin(aggregateStep(costs + x * pixelStride, previous.data(), previous.getMin(),
+                                     params_.p1, params_.p2, nbDisparities, false, current.data(),
+                                     sums + x * pixelStride));
+        std::swap(previous, current);
+      }
+
+      previous.reset();
+      for (int x = width_ - 1; x >= 0; --x) {
+        current.setMin(aggregateStep(costs + x * pixelStride, previous.data(), previous.getMin(),
+                                     params_.p1, params_.p2, nbDisparities, true, current.data(),
+                                     sums + x * pixelStride));
+        std::swap(previous, current);
+      }
+    }
+  }, nbThreads_);
+}
+
+// top to bottom and bottom to top, columns are independent
+void DisparityAnalyzerSGM::aggregateVertical() {
+  const int nbDisparities = params_.nbDisparities;
+  ThreadPool::global().parallelFor(0, width_, [this, nbDisparities](size_t begin, size_t end) {
+    const size_t pixelStride = nbDisparities;
+    const size_t rowStride = static_cast<size_t>(width_) * pixelStride;
+    std::vector<PathCosts> previous(end - begin, PathCosts(nbDisparities));
+    PathCosts current(nbDisparities);
+
+    auto scanRows = [&](int firstRow, int lastRow, int step) {
+      for (auto& column : previous) {
+        column.reset();
+      }
+      for (int y = firstRow; y != lastRow + step; y += step) {
+        for (size_t x = begin; x < end; ++x) {
+          const size_t offset = y * rowStride + x * pixelStride;
+          auto& columnPrevious = previous[x - begin];
+          current.setMin(aggregateStep(costs_.data() + offset, columnPrevious.data(),
+                                       columnPrevious.getMin(), params_.p1, params_.p2,
+                                       nbDisparities, true, current.data(),
+                                       aggregatedCosts_.data() + offset));
+          std::swap(columnPrevious, current);
+        }
+      }
+    };
+    scanRows(0, height_ - 1, 1);
+    scanRows(height_ - 1, 0, -1);
+  }, nbThreads_);
+}
+
+void DisparityAnalyzerSGM::computeDisparityMap() {
+  results.disparityMap.resize(Size(width_, height_));
+  const int nbDisparities = params_.nbDisparities;
+  ThreadPool::global().parallelFor(0, height_, [this, nbDisparities](size_t begin, size_t end) {
+    constexpr float invalid = std::numeric_limits<float>::quiet_NaN();
+    const size_t pixelStride = nbDisparities;
+    std::vector<uint16_t> bestRight(width_), bestRightCost(width_);
+
+    for (auto y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+      const uint16_t* sums =
+          aggregatedCosts_.data() + static_cast<size_t>(y) * width_ * pixelStride;
+
+      // right image disparities from the same volume: pixel xRight matches xRight - disparity,
+      // consecutive disparities of a left pixel are consecutive right pixels (vectorized)
+      std::fill(std::begin(bestRight), std::end(bestRight), PATH_SENTINEL);
+      std::fill(std::begin(bestRightCost), std::end(bestRightCost), PATH_SENTINEL);
+      for (int x = 0; x < width_; ++x) {
+        const uint16_t* s = sums + x * pixelStride;
+        const int xRight = x + params_.minDisparity;
+        const int first = std::min(std::max(-xRight, 0), nbDisparities);
+        const int last = std::max(std::min(width_ - xRight, nbDisparities), first);
+        uint16_t* rightCosts = bestRightCost.data() + xRight;
+        uint16_t* rightDisparities = bestRight.data() + xRight;
+        for (int d = first; d < last; ++d) {
+          const bool better = s[d] < rightCosts[d];
+          rightCosts[d] = better ? s[d] : rightCosts[d];
+          rightDisparities[d] = better ? static_cast<uint16_t>(d) : rightDisparities[d];
+        }
+      }
+
+      for (int x = 0; x < width_; ++x) {
+        const uint16_t* s = sums + x * pixelStride;
+        const uint16_t bestCost = minCost(s, 0, nbDisparities);
+        const auto best = static_cast<int>(std::find(s, s + nbDisparities, bestCost) - s);
+        const uint16_t secondBestCost = std::min(minCost(s, 0, best - 1),
+                                                 minCost(s, best + 2, nbDisparities));
+
+        const int xRight = x + params_.minDisparity + best;
+        const bool unique = secondBestCost * (100 - params_.uniquenessRatio) > bestCost * 100;
+        const bool consistent =
+            params_.maxLeftRightDifference < 0 ||
+            (0 <= xRight && xRight < width_ && bestRight[xRight] != PATH_SENTINEL &&
+             std::abs(bestRight[xRight] - best) <= params_.maxLeftRightDifference);
+        if (!unique || !consistent) {
+          results.disparityMap(y, x) = invalid;
+          continue;
+        }
+
+        // parabola through the costs around the best disparity
+        float offset = 0.0f;
+        if (0 < best && best < nbDisparities - 1) {
+          const int denominator = s[best - 1] - 2 * s[best] + s[best + 1];
+          if (denominator > 0) {
+            offset = static_cast<float>(s[best - 1] - s[best + 1]) / (2.0f * denominator);
+          }
+        }
+        results.disparityMap(y, x) = static_cast<float>(params_.minDisparity + best) + offset;
+      }
+    }
+  }, nbThreads_);
+}
+
+void DisparityAnalyzerSGM::computeStatistics() {
+  const float widthRatio = 100.0f / static_cast<float>(width_);
+  validDisparities_.clear();
+  for (int i = 0; i < width_ * height_; ++i) {
+    const float disparity = results.disparityMap[i];
+    if (!std::isnan(disparity)) {
+      validDisparities_.push_back(disparity * widthRatio);
+    }
+  }
+
+  if (validDisparities_.empty()) {
+    clearStatistics();
+    return;
+  }
+
+  // filter out extreme percentiles
+  quantiles_.percentiles(validDisparities_, {0.03f, 0.97f}, &range_);
+  results.minDisparityPercent = range_[0];
+  results.maxDisparityPercent = range_[1];
+  results.disparitiesPercent.clear();
+  std::copy_if(std::begin(validDisparities_), std::end(validDisparities_),
+               std::back_inserter(results.disparitiesPercent),
+               [this](float d) { return range_[0] <= d && d <= range_[1]; });
+}
+
+// no previous frame values are reported for a frame without valid disparities
+void DisparityAnalyzerSGM::clearStatistics() {
+  results.minDisparityPercent = 0.0;
+  results.maxDisparityPercent = 0.0;
+  results.disparitiesPercent.clear();
+}
+
+}  // namespace s3d
@@ -0,0 +1,116 @@
+#include "s3d/features/binary_descriptor_matcher.h"
+
+#include "s3d/concurrency/thread_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__POPCNT__)
+#include <nmmintrin.h>
+#endif
+
+namespace s3d {
+
+namespace {
+
+// queries and train descriptors processed together, 32 KB of train descriptors fit in L1
+constexpr size_t QUERY_BLOCK_SIZE = 64;
+constexpr size_t TRAIN_BLOCK_SIZE = 1024;
+
+#if !defined(__AVX2__) && !defined(__POPCNT__)
+inline int popcount64(uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+#endif
+
+inline int hamming256(const uint8_t* a, const uint8_t* b) {
+#if defined(__AVX2__)
+  // per nibble popcount lookup, then horizontal byte sums
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,  //
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i lowMask = _mm256_set1_epi8(0x0F);
+  __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+  __m256i counts = _mm256_add_epi8(
+      _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, lowMask)),
+      _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), lowMask)));
+  __m256i sums = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+  return _mm256_extract_epi32(sums, 0) + _mm256_extract_epi32(sums, 2) +
+         _mm256_extract_epi32(sums, 4) + _mm256_extract_epi32(sums, 6);
+#else
+  uint64_t wa[4], wb[4];
+  std::memcpy(wa, a, sizeof(wa));
+  std::memcpy(wb, b, sizeof(wb));
+#if defined(__POPCNT__)
+  return static_cast<int>(_mm_popcnt_u64(wa[0] ^ wb[0]) + _mm_popcnt_u64(wa[1] ^ wb[1]) +
+                          _mm_popcnt_u64(wa[2] ^ wb[2]) + _mm_popcnt_u64(wa[3] ^ wb[3]));
+#else
+  return popcount64(wa[0] ^ wb[0]) + popcount64(wa[1] ^ wb[1]) + popcount64(wa[2] ^ wb[2]) +
+         popcount64(wa[3] ^ wb[3]);
+#endif
+#endif
+}
+
+}  // namespace
+
+void BinaryDescriptorMatcher::setNumberOfThreads(size_t nbThreads) {
+  nbThreads_ = nbThreads;
+}
+
+std::vector<BinaryDescriptorMatcher::BestMatches> BinaryDescriptorMatcher::knnMatch(
+    const uint8_t* queries,
+    size_t nbQueries,
+    const uint8_t* train,
+    size_t nbTrain) const {
+  std::vector<BestMatches> matches(nbQueries);
+  const size_t nbQueryBlocks = (nbQueries + QUERY_BLOCK_SIZE - 1) / QUERY_BLOCK_SIZE;
+
+  ThreadPool::global().parallelFor(0, nbQueryBlocks, [&](size_t blockBegin, size_t blockEnd) {
+    for (size_t block = blockBegin; block < blockEnd; ++block) {
+      const size_t queryBegin = block * QUERY_BLOCK_SIZE;
+      const size_t queryEnd = std::min(queryBegin + QUERY_BLOCK_SIZE, nbQueries);
+
+      for (size_t trainBegin = 0; trainBegin < nbTrain; trainBegin += TRAIN_BLOCK_SIZE) {
+        const size_t trainEnd = std::min(trainBegin + TRAIN_BLOCK_SIZE, nbTrain);
+
+        for (size_t q = queryBegin; q < queryEnd; ++q) {
+          const uint8_t* query = queries + q * DESCRIPTOR_SIZE;
+          BestMatches best = matches[q];
+          for (size_t t = trainBegin; t < trainEnd; ++t) {
+            const int distance = hamming256(query, train + t * DESCRIPTOR_SIZE);
+            if (distance < best.secondDistance) {
+              if (distance < best.distance) {
+                best.secondDistance = best.distance;
+                best.secondTrainIdx = best.trainIdx;
+                best.distance = distance;
+                best.trainIdx = static_cast<int>(t);
+              } else {
+                best.secondDistance = distance;
+                best.secondTrainIdx = static_cast<int>(t);
+              }
+            }
+          }
+          matches[q] = best;
+        }
+      }
+    }
+  }, nbThreads_);
+
+  return matches;
+}
+
+// static
+int BinaryDescriptorMatcher::hammingDistance(const uint8_t* a, const uint8_t* b) {
+  return hamming256(a, b);
+}
+
+}  // namespace s3d
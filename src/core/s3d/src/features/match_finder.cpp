@@ -0,0 +1,35 @@
+#include "s3d/features/match_finder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace s3d {
+
+// static
+void MatchFinder::sortByQuality(Matches* matches) {
+  auto& qualities = matches->qualities;
+  if (qualities.empty()) {
+    return;
+  }
+  assert(matches->size() == 2);
+  assert((*matches)[0].size() == qualities.size() && (*matches)[1].size() == qualities.size());
+
+  std::vector<size_t> order(qualities.size());
+  std::iota(std::begin(order), std::end(order), size_t{0});
+  std::stable_sort(std::begin(order), std::end(order),
+                   [&qualities](size_t a, size_t b) { return qualities[a] > qualities[b]; });
+
+  Matches sorted(2);
+  sorted[0].reserve(order.size());
+  sorted[1].reserve(order.size());
+  sorted.qualities.reserve(order.size());
+  for (size_t i : order) {
+    sorted[0].push_back((*matches)[0][i]);
+    sorted[1].push_back((*matches)[1][i]);
+    sorted.qualities.push_back(qualities[i]);
+  }
+  *matches = std::move(sorted);
+}
+
+}  // namespace s3d
@@ -0,0 +1,260 @@
+#include "s3d/features/orb_extractor.h"
+
+#include "s3d/concurrency/thread_pool.h"
+#include "s3d/features/binary_descriptor_matcher.h"
+#include "s3d/utilities/rand.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace s3d {
+
+namespace {
+
+// intensity centroid patch, test pairs stay inside of it once rotated
+constexpr int HALF_PATCH_SIZE = 15;
+constexpr int PATTERN_RADIUS = 13;
+constexpr int BORDER = HALF_PATCH_SIZE + 1;
+
+constexpr int NB_TESTS = 8 * BinaryDescriptorMatcher::DESCRIPTOR_SIZE;
+constexpr int FAST_ARC_LENGTH = 9;
+constexpr int HARRIS_HALF_BLOCK_SIZE = 3;
+constexpr float HARRIS_K = 0.04f;
+
+// Bresenham circle of radius 3, clockwise from the top
+constexpr int CIRCLE[16][2] = {{0, -3}, {1, -3}, {2, -2}, {3, -1}, {3, 0},  {3, 1},
+                               {2, 2},  {1, 3},  {0, 3},  {-1, 3}, {-2, 2}, {-3, 1},
+                               {-3, 0}, {-3, -1}, {-2, -2}, {-1, -3}};
+
+struct TestPair {
+  int x1, y1, x2, y2;
+};
+
+// BRIEF Gaussian pairs (sigma = patch size / 5), same pattern for every extractor
+const std::array<TestPair, NB_TESTS>& testPattern() {
+  static const std::array<TestPair, NB_TESTS> pattern = [] {
+    Xoshiro256 generator(0x0bb);
+    auto uniform = [&generator] {
+      return (static_cast<double>(generator() >> 11U) + 0.5) * (1.0 / 9007199254740992.0);
+    };
+    auto gaussianPoint = [&uniform](int* x, int* y) {
+      constexpr double sigma = (2 * HALF_PATCH_SIZE + 1) / 5.0;
+      constexpr double twoPi = 6.283185307179586;
+      do {
+        const double radius = sigma * std::sqrt(-2.0 * std::log(uniform()));
+        const double angle = twoPi * uniform();
+        *x = static_cast<int>(std::lround(radius * std::cos(angle)));
+        *y = static_cast<int>(std::lround(radius * std::sin(angle)));
+      } while (*x * *x + *y * *y > PATTERN_RADIUS * PATTERN_RADIUS);
+    };
+
+    std::array<TestPair, NB_TESTS> pairs{};
+    for (auto& pair : pairs) {
+      gaussianPoint(&pair.x1, &pair.y1);
+      gaussianPoint(&pair.x2, &pair.y2);
+    }
+    return pairs;
+  }();
+  return pattern;
+}
+
+// 9 contiguous pixels of the circle brighter than center + threshold or darker than
+// center - threshold
+bool isFastCorner(const uint8_t* center, int stride, int threshold) {
+  const int brightLimit = *center + threshold;
+  const int darkLimit = *center - threshold;
+  auto pixel = [center, stride](int i) { return center[CIRCLE[i][1] * stride + CIRCLE[i][0]]; };
+
+  // any arc of 9 covers 2 of the 4 compass pixels
+  int nbBright = 0, nbDark = 0;
+  for (int i = 0; i < 16; i += 4) {
+    nbBright += pixel(i) > brightLimit ? 1 : 0;
+    nbDark += pixel(i) < darkLimit ? 1 : 0;
+  }
+  if (nbBright < 2 && nbDark < 2) {
+    return false;
+  }
+
+  uint32_t bright = 0, dark = 0;
+  for (int i = 0; i < 16; ++i) {
+    bright |= (pixel(i) > brightLimit ? 1U : 0U) << static_cast<unsigned int>(i);
+    dark |= (pixel(i) < darkLimit ? 1U : 0U) << static_cast<unsigned int>(i);
+  }
+  auto hasArc = [](uint32_t mask) {
+    uint32_t arcs = mask | (mask << 16U);
+    for (int i = 1; i < FAST_ARC_LENGTH; ++i) {
+      arcs &= arcs >> 1U;
+    }
+    return arcs != 0;
+  };
+  return hasArc(bright) || hasArc(dark);
+}
+
+float harrisResponse(const Image<uint8_t>& image, int x, int y) {
+  const uint8_t* data = image.data();
+  const int stride = image.width();
+  float xx = 0.0f, yy = 0.0f, xy = 0.0f;
+  for (int v = y - HARRIS_HALF_BLOCK_SIZE; v <= y + HARRIS_HALF_BLOCK_SIZE; ++v) {
+    for (int u = x - HARRIS_HALF_BLOCK_SIZE; u <= x + HARRIS_HALF_BLOCK_SIZE; ++u) {
+      const uint8_t* p = data + v * stride + u;
+      // Sobel
+      const int dx = (p[-stride + 1] + 2 * p[1] + p[stride + 1]) -
+                     (p[-stride - 1] + 2 * p[-1] + p[stride - 1]);
+      const int dy = (p[stride - 1] + 2 * p[stride] + p[stride + 1]) -
+                     (p[-stride - 1] + 2 * p[-stride] + p[-stride + 1]);
+      xx += static_cast<float>(dx * dx);
+      yy += static_cast<float>(dy * dy);
+      xy += static_cast<float>(dx * dy);
+    }
+  }
+  return xx * yy - xy * xy - HARRIS_K * (xx + yy) * (xx + yy);
+}
+
+// intensity centroid of the circular patch
+float orientation(const Image<uint8_t>& image, int x, int y) {
+  int m01 = 0, m10 = 0;
+  for (int v = -HALF_PATCH_SIZE; v <= HALF_PATCH_SIZE; ++v) {
+    for (int u = -HALF_PATCH_SIZE; u <= HALF_PATCH_SIZE; ++u) {
+      if (u * u + v * v <= HALF_PATCH_SIZE * HALF_PATCH_SIZE) {
+        const int value = image(y + v, x + u);
+        m10 += u * value;
+        m01 += v * value;
+      }
+    }
+  }
+  return std::atan2(static_cast<float>(m01), static_cast<float>(m10));
+}
+
+// separable [1 4 6 4 1] / 16 filter, borders replicated
+Image<uint8_t> smooth(const Image<uint8_t>& image, size_t nbThreads) {
+  constexpr int kernel[5] = {1, 4, 6, 4, 1};
+  const int width = image.width();
+  const int height = image.height();
+  std::vector<uint16_t> horizontal(static_cast<size_t>(width) * height);
+  Image<uint8_t> smoothed(Size(width, height));
+
+  auto& pool = ThreadPool::global();
+  pool.parallelFor(0, height, [&](size_t begin, size_t end) {
+    for (auto y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+      for (int x = 0; x < width; ++x) {
+        int sum = 0;
+        for (int k = -2; k <= 2; ++k) {
+          sum += kernel[k + 2] * image(y, std::min(std::max(x + k, 0), width - 1));
+        }
+        horizontal[static_cast<size_t>(y) * width + x] = static_cast<uint16_t>(sum);
+      }
+    }
+  }, nbThreads);
+  pool.parallelFor(0, height, [&](size_t begin, size_t end) {
+    for (auto y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+      for (int x = 0; x < width; ++x) {
+        int sum = 0;
+        for (int k = -2; k <= 2; ++k) {
+          const int v = std::min(std::max(y + k, 0), height - 1);
+          sum += kernel[k + 2] * horizontal[static_cast<size_t>(v) * width + x];
+        }
+        smoothed(y, x) = static_cast<uint8_t>((sum + 128) / 256);
+      }
+    }
+  }, nbThreads);
+  return smoothed;
+}
+
+}  // namespace
+
+OrbExtractor::OrbExtractor(const Parameters& params) : params_{params} {}
+
+void OrbExtractor::setNumberOfThreads(size_t nbThreads) {
+  nbThreads_ = nbThreads;
+}
+
+void OrbExtractor::detectAndCompute(const Image<uint8_t>& image,
+                                    std::vector<Keypoint>* keypoints,
+                                    std::vector<uint8_t>* descriptors) const {
+  keypoints->clear();
+  descriptors->clear();
+  if (image.width() <= 2 * BORDER || image.height() <= 2 * BORDER) {
+    return;
+  }
+  detect(image, keypoints);
+  compute(image, keypoints, descriptors);
+}
+
+void OrbExtractor::detect(const Image<uint8_t>& image, std::vector<Keypoint>* keypoints) const {
+  const int width = image.width();
+  const int height = image.height();
+
+  // Harris response of the FAST corners, 0 elsewhere
+  Image<float> responses(Size(width, height), 0.0f);
+  std::vector<std::vector<int>> cornersPerRow(height);
+  ThreadPool::global().parallelFor(BORDER, height - BORDER, [&](size_t begin, size_t end) {
+    for (auto y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+      for (int x = BORDER; x < width - BORDER; ++x) {
+        if (isFastCorner(image.data() + y * width + x, width, params_.fastThreshold)) {
+          cornersPerRow[y].push_back(x);
+          responses(y, x) = harrisResponse(image, x, y);
+        }
+      }
+    }
+  }, nbThreads_);
+
+  // 3x3 non maximum suppression, ties go to the first corner in raster order
+  for (int y = BORDER; y < height - BORDER; ++y) {
+    for (int x : cornersPerRow[y]) {
+      const float response = responses(y, x);
+      const bool isMax = response > responses(y - 1, x - 1) && response > responses(y - 1, x) &&
+                         response > responses(y - 1, x + 1) && response > responses(y, x - 1) &&
+                         response >= responses(y, x + 1) && response >= responses(y + 1, x - 1) &&
+                         response >= responses(y + 1, x) && response >= responses(y + 1, x + 1);
+      if (isMax && response > 0.0f) {
+        keypoints->push_back({static_cast<float>(x), static_cast<float>(y), 0.0f, response});
+      }
+    }
+  }
+
+  // strongest first, raster order for equal responses
+  std::stable_sort(
+      std::begin(*keypoints), std::end(*keypoints),
+      [](const Keypoint& a, const Keypoint& b) { return a.response > b.response; });
+  if (keypoints->size() > params_.maxNbFeatures) {
+    keypoints->resize(params_.maxNbFeatures);
+  }
+}
+
+void OrbExtractor::compute(const Image<uint8_t>& image,
+                           std::vector<Keypoint>* keypoints,
+                           std::vector<uint8_t>* descriptors) const {
+  constexpr size_t descriptorSize = BinaryDescriptorMatcher::DESCRIPTOR_SIZE;
+  const auto& pattern = testPattern();
+  const auto smoothed = smooth(image, nbThreads_);
+
+  descriptors->assign(keypoints->size() * descriptorSize, 0);
+  ThreadPool::global().parallelFor(0, keypoints->size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      auto& keypoint = (*keypoints)[i];
+      const auto x = static_cast<int>(keypoint.x);
+      const auto y = static_cast<int>(keypoint.y);
+      keypoint.angle = orientation(image, x, y);
+
+      // steered BRIEF: test pairs rotated by the keypoint orientation
+      const float c = std::cos(keypoint.angle);
+      const float s = std::sin(keypoint.angle);
+      auto valueAt = [&smoothed, x, y, c, s](int u, int v) {
+        const auto du = static_cast<int>(std::lround(c * u - s * v));
+        const auto dv = static_cast<int>(std::lround(s * u + c * v));
+        return smoothed(y + dv, x + du);
+      };
+
+      uint8_t* descriptor = descriptors->data() + i * descriptorSize;
+      for (int bit = 0; bit < NB_TESTS; ++bit) {
+        const auto& pair = pattern[bit];
+        if (valueAt(pair.x1, pair.y1) < valueAt(pair.x2, pair.y2)) {
+          descriptor[bit / 8] |= static_cast<uint8_t>(1U << static_cast<unsigned int>(bit % 8));
+        }
+      }
+    }
+  }, nbThreads_);
+}
+
+}  // namespace s3d
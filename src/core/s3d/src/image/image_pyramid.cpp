@@ -0,0 +1,170 @@
+#include "s3d/image/image_pyramid.h"
+
+#include "s3d/concurrency/thread_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace s3d {
+
+namespace {
+
+// rows of one output level processed per task
+constexpr size_t ROWS_PER_CHUNK = 32;
+
+// dst[x] = rounded mean of the 2x2 block at (2x, 0) of rows src0 and src1
+void halveRow(const uint8_t* src0, const uint8_t* src1, uint8_t* dst, int dstWidth) {
+  int x = 0;
+#if defined(__SSE2__)
+  const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+  const __m128i two = _mm_set1_epi16(2);
+  for (; x + 16 <= dstWidth; x += 16) {
+    __m128i outputs[2];
+    for (int half = 0; half < 2; ++half) {
+      const int offset = 2 * x + 16 * half;
+      __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + offset));
+      __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + offset));
+      __m128i sum = _mm_add_epi16(
+          _mm_add_epi16(_mm_and_si128(row0, lowBytes), _mm_srli_epi16(row0, 8)),
+          _mm_add_epi16(_mm_and_si128(row1, lowBytes), _mm_srli_epi16(row1, 8)));
+      outputs[half] = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                     _mm_packus_epi16(outputs[0], outputs[1]));
+  }
+#endif
+  for (; x < dstWidth; ++x) {
+    dst[x] = static_cast<uint8_t>(
+        (src0[2 * x] + src0[2 * x + 1] + src1[2 * x] + src1[2 * x + 1] + 2) >> 2);
+  }
+}
+
+}  // namespace
+
+void ImagePyramid::build(const uint8_t* data,
+                         Size size,
+                         size_t stride,
+                         int nbLevels,
+                         int border) {
+  assert(nbLevels >= 1);
+  border_ = std::max(border, 0);
+  nbLevels_ = 0;
+
+  allocateLevel(0, size);
+  for (int y = 0; y < size.getHeight(); ++y) {
+    std::memcpy(levelData(0) + y * levelStride(0), data + y * stride,
+                static_cast<size_t>(size.getWidth()));
+  }
+  nbLevels_ = 1;
+
+  while (nbLevels_ < nbLevels) {
+    const int previous = nbLevels_ - 1;
+    const Size previousSize = levelSize(previous);
+    const Size levelSize{previousSize.getWidth() / 2, previousSize.getHeight() / 2};
+    if (levelSize.getWidth() < 2 || levelSize.getHeight() < 2) {
+      break;
+    }
+    allocateLevel(nbLevels_, levelSize);
+
+    const uint8_t* src = levelData(previous);
+    const size_t srcStride = levelStride(previous);
+    uint8_t* dst = levelData(nbLevels_);
+    const size_t dstStride = levelStride(nbLevels_);
+    const auto nbRows = static_cast<size_t>(levelSize.getHeight());
+    const size_t nbChunks = (nbRows + ROWS_PER_CHUNK - 1) / ROWS_PER_CHUNK;
+    ThreadPool::global().parallelFor(0, nbChunks, [&](size_t chunkBegin, size_t chunkEnd) {
+      for (size_t y = chunkBegin * ROWS_PER_CHUNK; y < std::min(chunkEnd * ROWS_PER_CHUNK, nbRows);
+           ++y) {
+        const uint8_t* src0 = src + 2 * y * srcStride;
+        halveRow(src0, src0 + srcStride, dst + y * dstStride, levelSize.getWidth());
+      }
+    });
+    ++nbLevels_;
+  }
+
+  for (int level = 0; level < nbLevels_; ++level) {
+    replicateBorder(level);
+  }
+}
+
+void ImagePyramid::build(const Image<uint8_t>& image, int nbLevels, int border) {
+  build(image.data(), Size(image.width(), image.height()), static_cast<size_t>(image.width()),
+        nbLevels, border);
+}
+
+void ImagePyramid::clear() {
+  nbLevels_ = 0;
+}
+
+int ImagePyramid::nbLevels() const {
+  return nbLevels_;
+}
+
+int ImagePyramid::border() const {
+  return border_;
+}
+
+Size ImagePyramid::levelSize(int level) const {
+  assert(level < static_cast<int>(levels_.size()));
+  return levels_[level].size;
+}
+
+const uint8_t* ImagePyramid::levelData(int level) const {
+  assert(level < static_cast<int>(levels_.size()));
+  return levels_[level].buffer.data() + border_ * levelStride(level) + border_;
+}
+
+uint8_t* ImagePyramid::levelData(int level) {
+  assert(level < static_cast<int>(levels_.size()));
+  return levels_[level].buffer.data() + border_ * levelStride(level) + border_;
+}
+
+size_t ImagePyramid::levelStride(int level) const {
+  assert(level < static_cast<int>(levels_.size()));
+  return static_cast<size_t>(levels_[level].size.getWidth() + 2 * border_);
+}
+
+// static
+float ImagePyramid::levelScale(int level) {
+  return 1.0f / static_cast<float>(1 << level);
+}
+
+void ImagePyramid::allocateLevel(int level, Size size) {
+  if (static_cast<int>(levels_.size()) <= level) {
+    levels_.resize(static_cast<size_t>(level) + 1);
+  }
+  auto& newLevel = levels_[level];
+  newLevel.size = size;
+
+  // resize keeps the capacity, no reallocation when frame size does not change
+  newLevel.buffer.resize(static_cast<size_t>(size.getWidth() + 2 * border_) *
+                         static_cast<size_t>(size.getHeight() + 2 * border_));
+}
+
+void ImagePyramid::replicateBorder(int level) {
+  if (border_ == 0) {
+    return;
+  }
+  const int width = levelSize(level).getWidth();
+  const int height = levelSize(level).getHeight();
+  const size_t stride = levelStride(level);
+  uint8_t* first = levelData(level);
+
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = first + y * stride;
+    std::memset(row - border_, row[0], static_cast<size_t>(border_));
+    std::memset(row + width, row[width - 1], static_cast<size_t>(border_));
+  }
+  for (int i = 1; i <= border_; ++i) {
+    std::memcpy(first - i * stride - border_, first - border_, stride);
+    std::memcpy(first + (height - 1 + i) * stride - border_,
+                first + (height - 1) * stride - border_, stride);
+  }
+}
+
+}  // namespace s3d
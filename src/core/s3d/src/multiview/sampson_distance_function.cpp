@@ -2,11 +2,46 @@
 
 #include "s3d/multiview/stan_fundamental_matrix_solver.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace s3d {
 
 using SampleType = SampsonDistanceFunction::SampleType;
 using ModelType = SampsonDistanceFunction::ModelType;
 
+SampsonDistanceFunction::SampleDistance::SampleDistance(const ModelType& model)
+    : f_{StanFundamentalMatrixSolver::FundamentalMatrixFromAlignment(model)}, ft_{f_.transpose()} {}
+
+SampsonDistanceFunction::SoaSamples::SoaSamples(const std::vector<SampleType>& pts1,
+                                                const std::vector<SampleType>& pts2) {
+  assert(pts1.size() == pts2.size());
+  x1.reserve(pts1.size());
+  y1.reserve(pts1.size());
+  x2.reserve(pts2.size());
+  y2.reserve(pts2.size());
+  for (size_t i = 0; i < pts1.size(); ++i) {
+    x1.push_back(pts1[i].x() / pts1[i].z());
+    y1.push_back(pts1[i].y() / pts1[i].z());
+    x2.push_back(pts2[i].x() / pts2[i].z());
+    y2.push_back(pts2[i].y() / pts2[i].z());
+  }
+}
+
+void SampsonDistanceFunction::SoaSamples::resize(size_t nb) {
+  x1.resize(nb);
+  y1.resize(nb);
+  x2.resize(nb);
+  y2.resize(nb);
+}
+
+SampsonDistanceFunction::SoaView SampsonDistanceFunction::SoaSamples::view(size_t begin,
+                                                                            size_t end) const {
+  assert(begin <= end && end <= size());
+  return {x1.data() + begin, y1.data() + begin, x2.data() + begin, y2.data() + begin, end - begin};
+}
+
 // static
 void SampsonDistanceFunction::ComputeDistance(const std::vector<SampleType>& pts1,
                                               const std::vector<SampleType>& pts2,
@@ -15,27 +50,71 @@ void SampsonDistanceFunction::ComputeDistance(const std::vector<SampleType>& pts
   assert(pts1.size() == pts2.size());
   assert(pts1.size() == distances->size());
 
-  // create matrices with pts1h, pts2h
-  Eigen::MatrixXd pts1h(3, pts1.size()), pts2h(3, pts2.size());
-
-  // fill matrices
+  // one pass over the correspondences, no temporaries
+  const SampleDistance distance(model);
   for (size_t i = 0; i < pts1.size(); ++i) {
-    pts1h.block<3, 1>(0, i) = pts1[i];
-    pts2h.block<3, 1>(0, i) = pts2[i];
+    (*distances)[i] = distance(pts1[i], pts2[i]);
   }
+}
+
+// static
+void SampsonDistanceFunction::ComputeDistance(const SoaView& samples,
+                                              const ModelType& model,
+                                              size_t begin,
+                                              size_t end,
+                                              double* distances) {
+  assert(end <= samples.size());
 
-  auto f = StanFundamentalMatrixSolver::FundamentalMatrixFromAlignment(model);
-  auto pfp = (pts2h.transpose() * f).transpose();
-  auto pfp2 = pfp.cwiseProduct(pts1h);
-  auto colSum = pfp2.colwise().sum();
-  auto d = colSum.array().pow(2);
+  const Eigen::Matrix3d f = StanFundamentalMatrixSolver::FundamentalMatrixFromAlignment(model);
+  const double f00 = f(0, 0), f01 = f(0, 1), f02 = f(0, 2);
+  const double f10 = f(1, 0), f11 = f(1, 1), f12 = f(1, 2);
+  const double f20 = f(2, 0), f21 = f(2, 1), f22 = f(2, 2);
 
-  auto epl1 = f * pts1h;
-  auto epl2 = f.transpose() * pts2h;
-  auto coeff = epl1.row(0).array().square() + epl1.row(1).array().square() +
-               epl2.row(0).array().square() + epl2.row(1).array().square();
+  const double* x1 = samples.x1;
+  const double* y1 = samples.y1;
+  const double* x2 = samples.x2;
+  const double* y2 = samples.y2;
 
-  Eigen::VectorXd distancesVector = d.array() / coeff.array();
-  Eigen::VectorXd::Map(&distances->operator[](0), distancesVector.size()) = distancesVector;
+  size_t i = begin;
+#if defined(__AVX2__)
+  const __m256d vf00 = _mm256_set1_pd(f00), vf01 = _mm256_set1_pd(f01), vf02 = _mm256_set1_pd(f02);
+  const __m256d vf10 = _mm256_set1_pd(f10), vf11 = _mm256_set1_pd(f11), vf12 = _mm256_set1_pd(f12);
+  const __m256d vf20 = _mm256_set1_pd(f20), vf21 = _mm256_set1_pd(f21), vf22 = _mm256_set1_pd(f22);
+  for (; i + 4 <= end; i += 4) {
+    const __m256d px1 = _mm256_loadu_pd(x1 + i);
+    const __m256d py1 = _mm256_loadu_pd(y1 + i);
+    const __m256d px2 = _mm256_loadu_pd(x2 + i);
+    const __m256d py2 = _mm256_loadu_pd(y2 + i);
+
+    // F * x1 and F^T * x2 (first two coordinates)
+    const __m256d l0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vf00, px1),
+                                                   _mm256_mul_pd(vf01, py1)), vf02);
+    const __m256d l1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vf10, px1),
+                                                   _mm256_mul_pd(vf11, py1)), vf12);
+    const __m256d l2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vf20, px1),
+                                                   _mm256_mul_pd(vf21, py1)), vf22);
+    const __m256d m0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vf00, px2),
+                                                   _mm256_mul_pd(vf10, py2)), vf20);
+    const __m256d m1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vf01, px2),
+                                                   _mm256_mul_pd(vf11, py2)), vf21);
+
+    const __m256d pfp = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(px2, l0),
+                                                    _mm256_mul_pd(py2, l1)), l2);
+    const __m256d coeff = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(l0, l0), _mm256_mul_pd(l1, l1)),
+        _mm256_add_pd(_mm256_mul_pd(m0, m0), _mm256_mul_pd(m1, m1)));
+    _mm256_storeu_pd(distances + i, _mm256_div_pd(_mm256_mul_pd(pfp, pfp), coeff));
+  }
+#endif
+  for (; i < end; ++i) {
+    const double l0 = f00 * x1[i] + f01 * y1[i] + f02;
+    const double l1 = f10 * x1[i] + f11 * y1[i] + f12;
+    const double l2 = f20 * x1[i] + f21 * y1[i] + f22;
+    const double m0 = f00 * x2[i] + f10 * y2[i] + f20;
+    const double m1 = f01 * x2[i] + f11 * y2[i] + f21;
+    const double pfp = x2[i] * l0 + y2[i] * l1 + l2;
+    distances[i] = pfp * pfp / (l0 * l0 + l1 * l1 + m0 * m0 + m1 * m1);
+  }
 }
+
 }  // namespace s3d
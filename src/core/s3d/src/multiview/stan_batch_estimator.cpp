@@ -0,0 +1,122 @@
+#include "s3d/multiview/stan_batch_estimator.h"
+
+#include "s3d/concurrency/thread_pool.h"
+#include "s3d/utilities/eigen.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace s3d {
+
+StanBatchEstimator::StanBatchEstimator(Size imageSize)
+    : centerX_(imageSize.getWidth() / 2),
+      centerY_(imageSize.getHeight() / 2),
+      params_{StanFundamentalMatrixSolver::RobustParameters()} {}
+
+void StanBatchEstimator::setParameters(const robust::Parameters& params) {
+  params_ = params;
+}
+
+void StanBatchEstimator::setNumberOfThreads(size_t nbThreads) {
+  nbThreads_ = nbThreads;
+}
+
+std::vector<StanBatchEstimator::FrameResult> StanBatchEstimator::estimate(
+    const std::vector<MatchFinder::Matches>& frames) {
+  fillSharedPoints(frames);
+
+  std::vector<FrameResult> results(frames.size());
+  ThreadPool::global().parallelFor(0, frames.size(), [this, &results](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      results[i] = estimateFrame(i);
+    }
+  }, nbThreads_);
+  return results;
+}
+
+void StanBatchEstimator::fillSharedPoints(const std::vector<MatchFinder::Matches>& frames) {
+  offsets_.resize(frames.size() + 1);
+  offsets_[0] = 0;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    assert(frames[i].size() == 2 && frames[i][0].size() == frames[i][1].size());
+    offsets_[i + 1] = offsets_[i] + frames[i][0].size();
+  }
+  points_.resize(offsets_.back());
+
+  ThreadPool::global().parallelFor(0, frames.size(), [this, &frames](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const auto& matches = frames[i];
+      for (size_t j = 0; j < matches[0].size(); ++j) {
+        const size_t k = offsets_[i] + j;
+        points_.x1[k] = matches[0][j].x() - centerX_;
+        points_.y1[k] = matches[0][j].y() - centerY_;
+        points_.x2[k] = matches[1][j].x() - centerX_;
+        points_.y2[k] = matches[1][j].y() - centerY_;
+      }
+    }
+  }, nbThreads_);
+}
+
+StanBatchEstimator::FrameResult StanBatchEstimator::estimateFrame(size_t frame) const {
+  constexpr auto minNbSamples =
+      robust::estimation_algorithm_traits<StanFundamentalMatrixSolver>::MIN_NB_SAMPLES;
+
+  const size_t begin = offsets_[frame];
+  const size_t end = offsets_[frame + 1];
+  FrameResult result;
+  if (end - begin < static_cast<size_t>(minNbSamples)) {
+    return result;
+  }
+
+  // frames are the unit of parallelism, each estimation is sequential
+  robust::Parameters params = params_;
+  params.nbThreads = 1;
+  if (params.seed >= 0) {
+    params.seed += static_cast<int>(frame);
+  }
+
+  Estimator estimator(params);
+  try {
+    result.alignment = estimator(points_.view(begin, end));
+  } catch (const robust::NotEnoughInliersFound& /*exception*/) {
+    return result;
+  }
+  result.nbInliers = estimator.getBestInlierMask().count();
+  result.valid = true;
+  return result;
+}
+
+// static
+std::vector<StanAlignment> StanBatchEstimator::smoothTrack(const std::vector<FrameResult>& results,
+                                                           size_t radius) {
+  auto toVector = [](const StanAlignment& a) {
+    Eigen::Matrix<double, 7, 1> v;
+    v << a.ch_y, a.a_z, a.a_f, a.f_a_x, a.a_y_f, a.a_x_f, a.ch_z_f;
+    return v;
+  };
+
+  std::vector<StanAlignment> track(results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    const size_t first = i >= radius ? i - radius : 0;
+    const size_t last = std::min(results.size() - 1, i + radius);
+
+    Eigen::Matrix<double, 7, 1> sum = Eigen::Matrix<double, 7, 1>::Zero();
+    double sumWeights = 0.0;
+    for (size_t j = first; j <= last; ++j) {
+      if (results[j].valid) {
+        const auto weight = static_cast<double>(results[j].nbInliers);
+        sum += weight * toVector(results[j].alignment);
+        sumWeights += weight;
+      }
+    }
+    if (sumWeights <= 0.0) {
+      track[i] = results[i].alignment;
+      continue;
+    }
+    const Eigen::Matrix<double, 7, 1> mean = sum / sumWeights;
+    track[i] = {mean[0], mean[1], mean[2], mean[3], mean[4], mean[5], mean[6]};
+  }
+  return track;
+}
+
+}  // namespace s3d
@@ -2,24 +2,69 @@
 
 #include "s3d/utilities/eigen.h"
 
+#include <cmath>
+
 namespace s3d {
 
 using SampleType = StanFundamentalMatrixSolver::SampleType;
 using ModelType = StanFundamentalMatrixSolver::ModelType;
 
+// static
+template <class Row>
+void StanFundamentalMatrixSolver::FillEquation(const SampleType& x,
+                                               const SampleType& xp,
+                                               Row&& row,
+                                               double* b) {
+  // fill A
+  row << xp.x() - x.x(), xp.x(), xp.y(), -1, xp.x() * x.y();//, -x.y() * xp.y(),
+                                                            //   x.x() * xp.y() - xp.x() * x.y();
+  // fill b
+  *b = xp.y() - x.y();
+}
+
+void StanFundamentalMatrixSolver::NormalEquations::add(const SampleType& x, const SampleType& xp) {
+  Eigen::Matrix<double, 1, 5> row;
+  double b;
+  FillEquation(x, xp, row, &b);
+  AtA_.noalias() += row.transpose() * row;
+  Atb_ += b * row.transpose();
+}
+
+ModelType StanFundamentalMatrixSolver::NormalEquations::solve() const {
+  // columns are equilibrated first, pixel coordinates and their products have different scales
+  Eigen::Matrix<double, 5, 1> scale;
+  for (int i = 0; i < 5; ++i) {
+    scale[i] = AtA_(i, i) > 0.0 ? 1.0 / std::sqrt(AtA_(i, i)) : 1.0;
+  }
+  const Eigen::Matrix<double, 5, 5> scaledAtA = scale.asDiagonal() * AtA_ * scale.asDiagonal();
+  const Eigen::Matrix<double, 5, 1> y = scaledAtA.ldlt().solve(scale.cwiseProduct(Atb_));
+  const Eigen::Matrix<double, 5, 1> x = scale.cwiseProduct(y);
+  return {x[0], x[1], x[2], x[3], x[4], 0.0f, 0.0f};
+}
+
 // static
 ModelType StanFundamentalMatrixSolver::ComputeModel(const std::vector<SampleType>& pts1,
                                                     const std::vector<SampleType>& pts2) {
   assert(pts1.size() == pts2.size());
 
-  Eigen::MatrixXd A;
-  Eigen::VectorXd b;
-  std::tie(A, b) = BuildEquationSystem(pts1, pts2);
-
-  // solve
-  Eigen::VectorXd x = A.colPivHouseholderQr().solve(b); // QR
+  // minimal samples (RANSAC iterations): fixed size system, no heap allocation
+  constexpr int nbVariables = robust::estimation_algorithm_traits<StanFundamentalMatrixSolver>::MIN_NB_SAMPLES;
+  if (pts1.size() == nbVariables) {
+    Eigen::Matrix<double, nbVariables, nbVariables> A;
+    Eigen::Matrix<double, nbVariables, 1> b;
+    for (int i = 0; i < nbVariables; ++i) {
+      FillEquation(pts1[i], pts2[i], A.row(i), &b[i]);
+    }
+    Eigen::Matrix<double, nbVariables, 1> x = A.partialPivLu().solve(b);
+    return {x[0], x[1], x[2], x[3], x[4], 0.0f, 0.0f};
+  }
 
-  return {x[0], x[1], x[2], x[3], x[4], 0.0f, 0.0f};
+  // refit on inliers: 5x5 system whatever the number of correspondences
+  NormalEquations equations;
+  for (size_t i = 0; i < pts1.size(); ++i) {
+    equations.add(pts1[i], pts2[i]);
+  }
+  return equations.solve();
 }
 
 // static
@@ -35,17 +80,7 @@ std::pair<Eigen::MatrixXd, Eigen::VectorXd> StanFundamentalMatrixSolver::BuildEq
   Eigen::VectorXd b(pts1.size());
 
   for (size_t i = 0; i < pts1.size(); ++i) {
-    auto x = pts1[i];
-    auto xp = pts2[i];
-
-    // fill A
-    Eigen::VectorXd row(nbVariables);
-    row << xp.x() - x.x(), xp.x(), xp.y(), -1, xp.x() * x.y();//, -x.y() * xp.y(),
-                                                              //   x.x() * xp.y() - xp.x() * x.y();
-    A.block<1, nbVariables>(i, 0) = row;
-
-    // fill b
-    b[i] = xp.y() - x.y();
+    FillEquation(pts1[i], pts2[i], A.row(i), &b[i]);
   }
 
   return {A, b};
@@ -75,4 +110,25 @@ Eigen::Matrix3d StanFundamentalMatrixSolver::CenteredFundamentalMatrixFromAlignm
   return T.transpose() * F * T;
 }
 
+// static
+StanAlignment StanFundamentalMatrixSolver::ScaledAlignment(const StanAlignment& a, double scale) {
+  // x = S * xScaled with S = diag(1/scale, 1/scale, 1): F' = S * F * S, normalized by F'(2, 1)
+  StanAlignment scaled = a;
+  scaled.f_a_x = a.f_a_x * scale;
+  scaled.a_y_f = a.a_y_f / scale;
+  scaled.a_x_f = a.a_x_f / scale;
+  scaled.ch_z_f = a.ch_z_f / scale;
+  return scaled;
+}
+
+// static
+robust::Parameters StanFundamentalMatrixSolver::RobustParameters() {
+  // 95% quantile of the chi-square distribution with 1 degree of freedom
+  constexpr double expectedStd = 0.5;
+  robust::Parameters params;
+  params.nbTrials = 500;
+  params.distanceThreshold = std::sqrt(3.84 * expectedStd * expectedStd);
+  return params;
+}
+
 }  // namespace s3d
@@ -0,0 +1,90 @@
+#include "s3d/robust/inlier_mask.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__POPCNT__)
+#include <nmmintrin.h>
+#endif
+
+namespace s3d {
+namespace robust {
+
+namespace {
+
+inline size_t popcount64(uint64_t x) {
+#if defined(__AVX2__) || defined(__POPCNT__)
+  return static_cast<size_t>(_mm_popcnt_u64(x));
+#elif defined(__GNUC__)
+  return static_cast<size_t>(__builtin_popcountll(x));
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<size_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// bits of values[0, n) <= threshold, n <= 64
+inline uint64_t compareWord(const double* values, size_t n, double threshold) {
+  uint64_t word = 0;
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256d t = _mm256_set1_pd(threshold);
+  for (; i + 4 <= n; i += 4) {
+    const __m256d isInlier = _mm256_cmp_pd(_mm256_loadu_pd(values + i), t, _CMP_LE_OQ);
+    word |= static_cast<uint64_t>(_mm256_movemask_pd(isInlier)) << i;
+  }
+#endif
+  for (; i < n; ++i) {
+    word |= static_cast<uint64_t>(values[i] <= threshold ? 1U : 0U) << i;
+  }
+  return word;
+}
+
+}  // namespace
+
+constexpr size_t InlierMask::WORD_SIZE;
+
+InlierMask::InlierMask(size_t size) : size_{size}, words_((size + WORD_SIZE - 1) / WORD_SIZE) {}
+
+size_t InlierMask::fill(const std::vector<double>& distances, double distanceThreshold) {
+  assert(distances.size() == size_);
+  size_t nbInliers = 0;
+  for (size_t w = 0; w < words_.size(); ++w) {
+    const size_t begin = w * WORD_SIZE;
+    const size_t n = std::min(WORD_SIZE, size_ - begin);
+    words_[w] = compareWord(distances.data() + begin, n, distanceThreshold);
+    nbInliers += popcount64(words_[w]);
+  }
+  return nbInliers;
+}
+
+size_t InlierMask::count() const {
+  size_t nb = 0;
+  for (uint64_t word : words_) {
+    nb += popcount64(word);
+  }
+  return nb;
+}
+
+void InlierMask::set(size_t i, bool value) {
+  assert(i < size_);
+  const uint64_t bit = uint64_t{1} << (i % WORD_SIZE);
+  if (value) {
+    words_[i / WORD_SIZE] |= bit;
+  } else {
+    words_[i / WORD_SIZE] &= ~bit;
+  }
+}
+
+void InlierMask::swap(InlierMask& other) noexcept {
+  std::swap(size_, other.size_);
+  words_.swap(other.words_);
+}
+
+}  // namespace robust
+}  // namespace s3d
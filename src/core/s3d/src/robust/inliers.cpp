@@ -2,6 +2,8 @@
 
 #include "s3d/utilities/stats.h"
 
+#include <algorithm>
+#include <cassert>
 #include <tuple>
 
 namespace s3d {
@@ -20,7 +22,8 @@ bool Inliers::currentInliersAreBetter() const {
 
 void Inliers::chooseCurrentInliersAsBest() {
   bestNb_ = currentNb_;
-  std::copy(std::begin(current_), std::end(current_), std::begin(best_));
+  // current_ is overwritten by the next updateCurrent
+  best_.swap(current_);
 }
 
 void Inliers::updateBest() {
@@ -31,23 +34,21 @@ void Inliers::updateBest() {
 }
 
 void Inliers::updateCurrent(const std::vector<double> &distances) {
-  std::tie(current_, currentNb_) = computeInliers(distances);
+  currentNb_ = current_.fill(distances, distanceThreshold_);
 }
 
-std::pair<std::vector<bool>, size_t> Inliers::computeInliers(const std::vector<double> &distances) {
-  return Inliers::computeInliers(distances, distanceThreshold_);
+size_t Inliers::computeInliers(const std::vector<double> &distances, InlierMask *inliers) {
+  return Inliers::computeInliers(distances, distanceThreshold_, inliers);
 }
 
-std::pair<std::vector<bool>, size_t> Inliers::computeInliers(const std::vector<double> &distances, double distanceThreshold) {
-  std::vector<bool> inliers(distances.size());
-  size_t nbInliers = 0;
-  for (auto i = 0ULL; i < distances.size(); ++i) {
-    if (distances[i] <= distanceThreshold) {
-      inliers[i] = true;
-      nbInliers++;
-    }
+// static
+size_t Inliers::computeInliers(const std::vector<double> &distances,
+                               double distanceThreshold,
+                               InlierMask *inliers) {
+  if (inliers->size() != distances.size()) {
+    *inliers = InlierMask(distances.size());
   }
-  return {inliers, nbInliers};
+  return inliers->fill(distances, distanceThreshold);
 }
 
 size_t Inliers::getCurrentNb() const noexcept {
@@ -58,11 +59,15 @@ size_t Inliers::getBestNb() const noexcept {
   return bestNb_;
 }
 
+double Inliers::getBestScore() const {
+  return static_cast<double>(bestNb_);
+}
+
 double Inliers::getDistanceThreshold() const {
   return distanceThreshold_;
 }
 
-const std::vector<bool> &Inliers::getBest() const noexcept {
+const InlierMask &Inliers::getBest() const noexcept {
   return best_;
 }
 
@@ -74,7 +79,11 @@ bool Inliers::wereLastBest() {
 InliersLMedS::InliersLMedS(size_t nbPts, double distanceThreshold) : Inliers(nbPts, distanceThreshold) {}
 
 void InliersLMedS::updateCurrent(const std::vector<double> &distances) {
-  distanceThreshold_ = s3d::median(distances);
+  // same as s3d::median, with a reused buffer
+  assert(!distances.empty());
+  sortedDistances_.assign(std::begin(distances), std::end(distances));
+  distanceThreshold_ =
+      s3d::median_in_place(std::begin(sortedDistances_), std::end(sortedDistances_));
 }
 
 bool InliersLMedS::currentInliersAreBetter() const {
@@ -85,8 +94,42 @@ void InliersLMedS::chooseCurrentInliersAsBest() {
   bestDist_ = distanceThreshold_;
 }
 
-std::pair<std::vector<bool>, size_t> InliersLMedS::computeInliers(const std::vector<double> &distances) {
-  return Inliers::computeInliers(distances, bestDist_);
+size_t InliersLMedS::computeInliers(const std::vector<double> &distances, InlierMask *inliers) {
+  return Inliers::computeInliers(distances, bestDist_, inliers);
+}
+
+double InliersLMedS::getBestMedian() const noexcept {
+  return bestDist_;
+}
+
+double InliersLMedS::getBestScore() const {
+  return -bestDist_;
+}
+
+
+InliersMSAC::InliersMSAC(size_t nbPts, double distanceThreshold) : Inliers(nbPts, distanceThreshold) {}
+
+void InliersMSAC::updateCurrent(const std::vector<double> &distances) {
+  Inliers::updateCurrent(distances);
+  const double maxCost = distanceThreshold_ * distanceThreshold_;
+  double cost = 0.0;
+  for (double distance : distances) {
+    cost += std::min(distance * distance, maxCost);
+  }
+  currentCost_ = cost;
+}
+
+bool InliersMSAC::currentInliersAreBetter() const {
+  return currentCost_ < bestCost_;
+}
+
+void InliersMSAC::chooseCurrentInliersAsBest() {
+  Inliers::chooseCurrentInliersAsBest();
+  bestCost_ = currentCost_;
+}
+
+double InliersMSAC::getBestScore() const {
+  return -bestCost_;
 }
 
 } // namespace robust
@@ -15,12 +15,19 @@ Trials::Trials(size_t nbPts, size_t minNbSamples, size_t maxNbTrials, Parameters
           oneOverNbPts_{1.0 / nbPts} {}
 
 void Trials::updateNb(double currentNbInliers) {
+  updateNbFromRatio(currentNbInliers * oneOverNbPts_);
+}
+
+void Trials::updateNb(double nbInliersInSubset, size_t subsetSize) {
+  updateNbFromRatio(nbInliersInSubset / static_cast<double>(subsetSize));
+}
+
+void Trials::updateNbFromRatio(double ratioOfInliers) {
   constexpr double eps = 1E-15;
 
   size_t newNb = 0;
-  double ratioOfInliers = currentNbInliers * oneOverNbPts_;
-  if (ratioOfInliers <= (1 - eps)) {
-    auto ratioPow = std::pow(ratioOfInliers, minNbSamples_);
+  auto ratioPow = goodModelAcceptance_ * std::pow(ratioOfInliers, minNbSamples_);
+  if (ratioPow <= (1 - eps)) {
     if (ratioPow > eps) {
       auto logOneMinusRatioPow = std::log(1 - ratioPow);
       newNb = size_t(std::ceil(logOneMinusConf_ / logOneMinusRatioPow));
@@ -40,6 +47,18 @@ bool Trials::reachedMaxNb() {
   return hasReached;
 }
 
+void Trials::setGoodModelAcceptance(double probability) {
+  goodModelAcceptance_ = probability;
+}
+
+size_t Trials::remainingNb() const {
+  return curNb_ < maxNb_ ? maxNb_ - curNb_ : 0;
+}
+
+void Trials::addNb(size_t nbTrials) {
+  curNb_ += nbTrials;
+}
+
 size_t Trials::currentNb() {
   return curNb_;
 }
@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+
+#include "s3d/concurrency/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+
+using s3d::ThreadPool;
+
+TEST(thread_pool, submit_returns_result) {
+  ThreadPool pool(2);
+  auto future = pool.submit([] { return 42; });
+  EXPECT_EQ(future.get(), 42);
+}
+
+TEST(thread_pool, submit_without_workers_runs_inline) {
+  ThreadPool pool(0);
+  auto future = pool.submit([] { return 1; });
+  EXPECT_EQ(future.get(), 1);
+}
+
+TEST(thread_pool, parallel_for_visits_each_index_once) {
+  ThreadPool pool(3);
+  std::vector<int> visits(1000, 0);
+  pool.parallelFor(0, visits.size(), [&visits](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      visits[i]++;
+    }
+  });
+  EXPECT_EQ(std::accumulate(std::begin(visits), std::end(visits), 0), 1000);
+  EXPECT_EQ(*std::max_element(std::begin(visits), std::end(visits)), 1);
+}
+
+TEST(thread_pool, parallel_for_respects_max_parallelism) {
+  ThreadPool pool(3);
+  std::atomic<int> nbChunks{0};
+  pool.parallelFor(0, 100, [&nbChunks](size_t, size_t) { nbChunks++; }, 2);
+  EXPECT_EQ(nbChunks, 2);
+}
+
+TEST(thread_pool, nested_parallel_for_does_not_deadlock) {
+  ThreadPool pool(2);
+  std::atomic<int> count{0};
+  pool.parallelFor(0, 4, [&pool, &count](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      pool.parallelFor(0, 10, [&count](size_t b, size_t e) { count += static_cast<int>(e - b); });
+    }
+  });
+  EXPECT_EQ(count, 40);
+}
+
+TEST(thread_pool, parallel_for_rethrows_exception) {
+  ThreadPool pool(2);
+  EXPECT_THROW(pool.parallelFor(0, 10, [](size_t, size_t) { throw std::runtime_error("error"); }),
+               std::runtime_error);
+}
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include "s3d/disparity/disparities_dense.h"
+#include "s3d/disparity/disparities_sparse.h"
+
+using s3d::DisparitiesDense;
+using s3d::DisparitiesSparse;
+using s3d::DisparityPoint;
+using s3d::Image;
+using s3d::Size;
+
+TEST(disparities_dense, min_max_and_points_from_map) {
+  Image<uint8_t> map(Size(4, 3), uint8_t{0});
+  map(1, 2) = 10;
+  map(2, 0) = 3;
+
+  DisparitiesDense disparities(map);
+
+  // map values are left - right columns
+  EXPECT_EQ(disparities.min().disparity.col, -10);
+  EXPECT_EQ(disparities.min().leftPos.row, 1);
+  EXPECT_EQ(disparities.min().leftPos.col, 2);
+  EXPECT_EQ(disparities.max().disparity.col, -3);
+
+  auto points = disparities.getDisparities();
+  ASSERT_EQ(points.size(), 2);
+  EXPECT_EQ(points[0].leftPos.col, 2);
+  EXPECT_EQ(points[0].disparity.col, -10);
+  EXPECT_EQ(points[1].leftPos.row, 2);
+  EXPECT_EQ(points[1].disparity.col, -3);
+}
+
+TEST(disparities_dense, min_max_ignore_ambiguous_pixels) {
+  // 0: no disparity, e.g. rejected by the block matcher
+  Image<uint8_t> map(Size(5, 2), uint8_t{0});
+  map(0, 1) = 7;
+  map(1, 3) = 2;
+  map(1, 4) = 5;
+
+  DisparitiesDense disparities(map);
+
+  EXPECT_EQ(disparities.min().disparity.col, -7);
+  EXPECT_EQ(disparities.min().leftPos.row, 0);
+  EXPECT_EQ(disparities.min().leftPos.col, 1);
+  EXPECT_EQ(disparities.max().disparity.col, -2);
+  EXPECT_EQ(disparities.max().leftPos.row, 1);
+  EXPECT_EQ(disparities.max().leftPos.col, 3);
+
+  DisparitiesDense ambiguous(Image<uint8_t>(Size(5, 2), uint8_t{0}));
+  EXPECT_EQ(ambiguous.min().disparity.col, 0);
+  EXPECT_EQ(ambiguous.max().disparity.col, 0);
+}
+
+TEST(disparities_sparse, map_drawn_at_left_positions) {
+  std::vector<DisparityPoint> points{{{0, 1}, {0, -5}}, {{2, 3}, {1, -300}}, {{1, 0}, {0, 4}}};
+  DisparitiesSparse disparities(points, Size(4, 3));
+
+  const auto& map = disparities.getDisparityMap();
+  ASSERT_EQ(map.width(), 4);
+  ASSERT_EQ(map.height(), 3);
+  EXPECT_EQ(map(0, 1), 5);
+  EXPECT_EQ(map(2, 3), 255);
+  EXPECT_EQ(map(1, 0), 0);
+  EXPECT_EQ(map(1, 1), 0);
+
+  EXPECT_EQ(disparities.min().disparity.col, -300);
+  EXPECT_EQ(disparities.max().disparity.col, 4);
+  EXPECT_EQ(disparities.getDisparities().size(), 3);
+
+  std::unique_ptr<s3d::Disparities> clone(disparities.clone());
+  EXPECT_EQ(clone->getDisparityMap(), map);
+}
@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include "s3d/disparity/disparities_dense.h"
+#include "s3d/disparity/disparity_algorithm_bm.h"
+#include "s3d/utilities/rand.h"
+
+using s3d::DisparityAlgorithmBM;
+using s3d::Image;
+using s3d::Size;
+
+namespace {
+
+Image<uint8_t> randomTexture(Size size, uint64_t seed) {
+  s3d::Xoshiro256 generator(seed);
+  Image<uint8_t> image(size);
+  for (int i = 0; i < size.getArea(); ++i) {
+    image[i] = static_cast<uint8_t>(generator.bounded(256));
+  }
+  return image;
+}
+
+}  // namespace
+
+TEST(disparity_algorithm_bm, constant_shift_is_found) {
+  const Size size(120, 80);
+  constexpr int shift = 9;
+  auto left = randomTexture(size, 0);
+  Image<uint8_t> right = randomTexture(size, 1);
+  for (int y = 0; y < size.getHeight(); ++y) {
+    for (int x = shift; x < size.getWidth(); ++x) {
+      right(y, x - shift) = left(y, x);
+    }
+  }
+
+  DisparityAlgorithmBM algorithm;
+  algorithm.setNumberOfThreads(1);
+  auto disparities = algorithm.ComputeDisparities(left, right);
+
+  const auto& map = disparities->getDisparityMap();
+  ASSERT_EQ(map.width(), size.getWidth());
+  ASSERT_EQ(map.height(), size.getHeight());
+  for (int y = 0; y < size.getHeight(); ++y) {
+    for (int x = 20; x < size.getWidth() - 10; ++x) {
+      ASSERT_EQ(map(y, x), shift) << y << ", " << x;
+    }
+  }
+  EXPECT_EQ(disparities->min().disparity.col, -shift);
+}
+
+TEST(disparity_algorithm_bm, same_map_with_all_threads) {
+  const Size size(100, 70);
+  auto left = randomTexture(size, 2);
+  auto right = randomTexture(size, 3);
+  right.block(0, 0, 70, 96) = left.block(0, 4, 70, 96);
+
+  DisparityAlgorithmBM sequential({32, 9, 15}), parallel({32, 9, 15});
+  sequential.setNumberOfThreads(1);
+  parallel.setNumberOfThreads(0);
+
+  EXPECT_EQ(sequential.ComputeDisparities(left, right)->getDisparityMap(),
+            parallel.ComputeDisparities(left, right)->getDisparityMap());
+}
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+
+#include "s3d/disparity/disparity_algorithm_orb.h"
+#include "s3d/utilities/rand.h"
+
+using s3d::DisparityAlgorithmORB;
+using s3d::Image;
+using s3d::Size;
+
+namespace {
+
+// overlapping flat rectangles, corners everywhere
+Image<uint8_t> rectangles(Size size, uint64_t seed) {
+  s3d::Xoshiro256 generator(seed);
+  Image<uint8_t> image(size, uint8_t{128});
+  for (int i = 0; i < 400; ++i) {
+    const auto x = static_cast<int>(generator.bounded(size.getWidth()));
+    const auto y = static_cast<int>(generator.bounded(size.getHeight()));
+    const auto w = std::min(static_cast<int>(generator.bounded(30)) + 4, size.getWidth() - x);
+    const auto h = std::min(static_cast<int>(generator.bounded(30)) + 4, size.getHeight() - y);
+    image.block(y, x, h, w).fill(static_cast<uint8_t>(generator.bounded(256)));
+  }
+  return image;
+}
+
+}  // namespace
+
+TEST(disparity_algorithm_orb, matches_follow_the_shift) {
+  const Size size(320, 240);
+  constexpr int shift = 7;
+  auto left = rectangles(size, 0);
+  Image<uint8_t> right(size, uint8_t{128});
+  right.block(0, 0, 240, 320 - shift) = left.block(0, shift, 240, 320 - shift);
+
+  DisparityAlgorithmORB algorithm;
+  auto disparities = algorithm.ComputeDisparities(left, right);
+
+  auto points = disparities->getDisparities();
+  ASSERT_GT(points.size(), 100);
+  size_t nbCorrect = 0;
+  for (const auto& p : points) {
+    nbCorrect += p.disparity.row == 0 && p.disparity.col == -shift ? 1 : 0;
+  }
+  EXPECT_GT(nbCorrect, 0.9 * points.size());
+}
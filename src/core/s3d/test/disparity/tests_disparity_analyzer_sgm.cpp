@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+
+#include "s3d/disparity/disparity_analyzer_sgm.h"
+#include "s3d/utilities/rand.h"
+
+#include <cmath>
+
+using s3d::DisparityAnalyzerSGM;
+using s3d::Image;
+using s3d::Size;
+
+namespace {
+
+Image<uint8_t> randomTexture(Size size, uint64_t seed) {
+  s3d::Xoshiro256 generator(seed);
+  Image<uint8_t> image(size);
+  for (int i = 0; i < size.getArea(); ++i) {
+    image[i] = static_cast<uint8_t>(generator.bounded(256));
+  }
+  return image;
+}
+
+// right(y, x + disparity(y, x)) = left(y, x), occluded pixels keep the texture of right
+Image<uint8_t> shiftedView(const Image<uint8_t>& left,
+                           Image<uint8_t> right,
+                           const Image<int>& disparities) {
+  for (int y = 0; y < left.height(); ++y) {
+    for (int x = 0; x < left.width(); ++x) {
+      const int xRight = x + disparities(y, x);
+      if (0 <= xRight && xRight < left.width()) {
+        right(y, xRight) = left(y, x);
+      }
+    }
+  }
+  return right;
+}
+
+}  // namespace
+
+TEST(disparity_analyzer_sgm, constant_disparity_is_found) {
+  const Size size(160, 90);
+  constexpr int disparity = -6;
+  auto left = randomTexture(size, 0);
+  auto right = shiftedView(left, randomTexture(size, 1), Image<int>(size, disparity));
+
+  DisparityAnalyzerSGM analyzer;
+  analyzer.setNumberOfThreads(1);
+  ASSERT_TRUE(analyzer.analyze(left, right));
+
+  // borders of the right image are unmatched, everything else must be found
+  const auto& map = analyzer.results.disparityMap;
+  int nbCorrect = 0;
+  for (int y = 0; y < size.getHeight(); ++y) {
+    for (int x = 10; x < size.getWidth() - 10; ++x) {
+      if (!std::isnan(map(y, x)) && std::abs(map(y, x) - disparity) < 0.5f) {
+        ++nbCorrect;
+      }
+    }
+  }
+  EXPECT_GT(nbCorrect, 0.95 * size.getHeight() * (size.getWidth() - 20));
+
+  const float disparityPercent = 100.0f * disparity / size.getWidth();
+  EXPECT_NEAR(analyzer.results.minDisparityPercent, disparityPercent, 0.5);
+  EXPECT_NEAR(analyzer.results.maxDisparityPercent, disparityPercent, 0.5);
+  EXPECT_TRUE(analyzer.getFeaturePointsLeft().empty());
+}
+
+TEST(disparity_analyzer_sgm, range_covers_foreground_and_background) {
+  const Size size(160, 96);
+  constexpr int background = 4;
+  constexpr int foreground = -10;
+
+  // foreground square covering a quarter of the image
+  Image<int> disparities(size, background);
+  disparities.block(24, 40, 48, 80).fill(foreground);
+
+  auto left = randomTexture(size, 2);
+  auto right = shiftedView(left, randomTexture(size, 3), disparities);
+
+  DisparityAnalyzerSGM analyzer;
+  ASSERT_TRUE(analyzer.analyze(left, right));
+
+  const float widthRatio = 100.0f / size.getWidth();
+  EXPECT_NEAR(analyzer.results.minDisparityPercent, foreground * widthRatio, 0.5);
+  EXPECT_NEAR(analyzer.results.maxDisparityPercent, background * widthRatio, 0.5);
+
+  const auto& map = analyzer.results.disparityMap;
+  EXPECT_NEAR(map(48, 80), foreground, 0.5f);
+  EXPECT_NEAR(map(5, 5), background, 0.5f);
+}
+
+TEST(disparity_analyzer_sgm, same_results_with_all_threads) {
+  const Size size(96, 64);
+  auto left = randomTexture(size, 4);
+  auto right = shiftedView(left, randomTexture(size, 5), Image<int>(size, 3));
+
+  DisparityAnalyzerSGM sequential, parallel;
+  sequential.setNumberOfThreads(1);
+  parallel.setNumberOfThreads(0);
+  sequential.analyze(left, right);
+  parallel.analyze(left, right);
+
+  EXPECT_EQ(sequential.getDisparitiesPercent(), parallel.getDisparitiesPercent());
+}
+
+TEST(disparity_analyzer_sgm, empty_images_are_not_analyzed) {
+  DisparityAnalyzerSGM analyzer;
+  EXPECT_FALSE(analyzer.analyze(Image<uint8_t>{}, Image<uint8_t>{}));
+}
+
+TEST(disparity_analyzer_sgm, frames_without_valid_disparities_clear_the_range) {
+  const Size size(96, 64);
+  auto left = randomTexture(size, 6);
+  auto right = shiftedView(left, randomTexture(size, 7), Image<int>(size, 5));
+
+  DisparityAnalyzerSGM analyzer;
+  ASSERT_TRUE(analyzer.analyze(left, right));
+  ASSERT_NE(analyzer.results.maxDisparityPercent, 0.0);
+
+  // no disparity can be better than the second best by 100%
+  auto params = analyzer.getParameters();
+  params.uniquenessRatio = 100;
+  analyzer.setParameters(params);
+  EXPECT_FALSE(analyzer.analyze(left, right));
+  EXPECT_EQ(analyzer.results.minDisparityPercent, 0.0);
+  EXPECT_EQ(analyzer.results.maxDisparityPercent, 0.0);
+  EXPECT_TRUE(analyzer.getDisparitiesPercent().empty());
+
+  params.uniquenessRatio = 10;
+  analyzer.setParameters(params);
+  ASSERT_TRUE(analyzer.analyze(left, right));
+  EXPECT_FALSE(analyzer.analyze(Image<uint8_t>{}, Image<uint8_t>{}));
+  EXPECT_EQ(analyzer.results.minDisparityPercent, 0.0);
+  EXPECT_EQ(analyzer.results.maxDisparityPercent, 0.0);
+  EXPECT_TRUE(analyzer.getDisparitiesPercent().empty());
+}
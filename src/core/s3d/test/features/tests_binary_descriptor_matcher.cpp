@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+
+#include "s3d/features/binary_descriptor_matcher.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using s3d::BinaryDescriptorMatcher;
+
+namespace {
+
+constexpr size_t descriptorSize = BinaryDescriptorMatcher::DESCRIPTOR_SIZE;
+
+std::vector<uint8_t> randomDescriptors(size_t nbDescriptors, unsigned int seed) {
+  std::mt19937 mt(seed);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> descriptors(nbDescriptors * descriptorSize);
+  for (auto& value : descriptors) {
+    value = static_cast<uint8_t>(dist(mt));
+  }
+  return descriptors;
+}
+
+int naiveDistance(const uint8_t* a, const uint8_t* b) {
+  int distance = 0;
+  for (size_t i = 0; i < descriptorSize; ++i) {
+    for (int bit = 0; bit < 8; ++bit) {
+      distance += ((a[i] ^ b[i]) >> bit) & 1;
+    }
+  }
+  return distance;
+}
+
+}  // namespace
+
+TEST(binary_descriptor_matcher, hamming_distance_counts_different_bits) {
+  std::vector<uint8_t> a(descriptorSize, 0);
+  std::vector<uint8_t> b(descriptorSize, 0);
+  EXPECT_EQ(BinaryDescriptorMatcher::hammingDistance(a.data(), b.data()), 0);
+
+  b[0] = 0x01;
+  b[17] = 0xFF;
+  b[31] = 0x80;
+  EXPECT_EQ(BinaryDescriptorMatcher::hammingDistance(a.data(), b.data()), 10);
+
+  std::fill(b.begin(), b.end(), 0xFF);
+  EXPECT_EQ(BinaryDescriptorMatcher::hammingDistance(a.data(), b.data()), 256);
+}
+
+TEST(binary_descriptor_matcher, knn_match_same_as_naive_search) {
+  // more train descriptors than a train block, queries span several query blocks
+  const size_t nbQueries = 150;
+  const size_t nbTrain = 1500;
+  auto queries = randomDescriptors(nbQueries, 1);
+  auto train = randomDescriptors(nbTrain, 2);
+
+  BinaryDescriptorMatcher matcher;
+  auto matches = matcher.knnMatch(queries.data(), nbQueries, train.data(), nbTrain);
+
+  ASSERT_EQ(matches.size(), nbQueries);
+  for (size_t q = 0; q < nbQueries; ++q) {
+    std::vector<int> distances(nbTrain);
+    for (size_t t = 0; t < nbTrain; ++t) {
+      distances[t] = naiveDistance(&queries[q * descriptorSize], &train[t * descriptorSize]);
+    }
+    std::vector<int> sorted = distances;
+    std::partial_sort(sorted.begin(), sorted.begin() + 2, sorted.end());
+
+    EXPECT_EQ(matches[q].distance, sorted[0]);
+    EXPECT_EQ(matches[q].secondDistance, sorted[1]);
+    EXPECT_EQ(distances[matches[q].trainIdx], sorted[0]);
+    EXPECT_EQ(distances[matches[q].secondTrainIdx], sorted[1]);
+    EXPECT_NE(matches[q].trainIdx, matches[q].secondTrainIdx);
+  }
+}
+
+TEST(binary_descriptor_matcher, knn_match_finds_exact_copy) {
+  auto train = randomDescriptors(100, 3);
+  std::vector<uint8_t> query(train.begin() + 42 * descriptorSize,
+                             train.begin() + 43 * descriptorSize);
+
+  BinaryDescriptorMatcher matcher;
+  matcher.setNumberOfThreads(1);
+  auto matches = matcher.knnMatch(query.data(), 1, train.data(), 100);
+
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].trainIdx, 42);
+  EXPECT_EQ(matches[0].distance, 0);
+}
+
+TEST(binary_descriptor_matcher, knn_match_single_train_has_no_second) {
+  auto train = randomDescriptors(1, 4);
+  auto queries = randomDescriptors(3, 5);
+
+  BinaryDescriptorMatcher matcher;
+  auto matches = matcher.knnMatch(queries.data(), 3, train.data(), 1);
+
+  for (const auto& match : matches) {
+    EXPECT_EQ(match.trainIdx, 0);
+    EXPECT_EQ(match.secondTrainIdx, -1);
+  }
+}
@@ -0,0 +1,36 @@
+#include "gtest/gtest.h"
+
+#include "s3d/features/match_finder.h"
+
+using s3d::MatchFinder;
+
+TEST(match_finder, sort_by_quality_best_first) {
+  MatchFinder::Matches matches(2);
+  for (int i = 0; i < 4; ++i) {
+    matches[0].emplace_back(i, 0);
+    matches[1].emplace_back(i, 1);
+  }
+  matches.qualities = {0.2, 0.9, 0.2, 0.5};
+
+  MatchFinder::sortByQuality(&matches);
+
+  EXPECT_EQ(matches.qualities, std::vector<double>({0.9, 0.5, 0.2, 0.2}));
+  EXPECT_EQ(matches[0][0].x(), 1);
+  EXPECT_EQ(matches[1][1].x(), 3);
+  // stable for equal qualities
+  EXPECT_EQ(matches[0][2].x(), 0);
+  EXPECT_EQ(matches[0][3].x(), 2);
+}
+
+TEST(match_finder, sort_without_qualities_keeps_order) {
+  MatchFinder::Matches matches(2);
+  matches[0].emplace_back(1, 0);
+  matches[0].emplace_back(0, 0);
+  matches[1].emplace_back(1, 1);
+  matches[1].emplace_back(0, 1);
+
+  MatchFinder::sortByQuality(&matches);
+
+  EXPECT_EQ(matches[0][0].x(), 1);
+  EXPECT_EQ(matches[0][1].x(), 0);
+}
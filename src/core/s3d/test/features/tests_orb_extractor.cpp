@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+
+#include "s3d/features/binary_descriptor_matcher.h"
+#include "s3d/features/orb_extractor.h"
+#include "s3d/utilities/rand.h"
+
+using s3d::Image;
+using s3d::OrbExtractor;
+using s3d::Size;
+
+namespace {
+
+Image<uint8_t> randomTexture(Size size, uint64_t seed) {
+  s3d::Xoshiro256 generator(seed);
+  Image<uint8_t> image(size);
+  for (int i = 0; i < size.getArea(); ++i) {
+    image[i] = static_cast<uint8_t>(generator.bounded(256));
+  }
+  return image;
+}
+
+}  // namespace
+
+TEST(orb_extractor, strongest_keypoints_away_from_borders) {
+  const Size size(200, 150);
+  OrbExtractor extractor({100, 20});
+
+  std::vector<OrbExtractor::Keypoint> keypoints;
+  std::vector<uint8_t> descriptors;
+  extractor.detectAndCompute(randomTexture(size, 0), &keypoints, &descriptors);
+
+  ASSERT_EQ(keypoints.size(), 100);
+  EXPECT_EQ(descriptors.size(), 100 * s3d::BinaryDescriptorMatcher::DESCRIPTOR_SIZE);
+  for (size_t i = 0; i < keypoints.size(); ++i) {
+    EXPECT_GE(keypoints[i].x, 15);
+    EXPECT_LT(keypoints[i].x, size.getWidth() - 15);
+    EXPECT_GE(keypoints[i].y, 15);
+    EXPECT_LT(keypoints[i].y, size.getHeight() - 15);
+    if (i > 0) {
+      EXPECT_GE(keypoints[i - 1].response, keypoints[i].response);
+    }
+  }
+}
+
+TEST(orb_extractor, same_features_with_all_threads) {
+  const auto image = randomTexture(Size(160, 120), 1);
+  OrbExtractor sequential, parallel;
+  sequential.setNumberOfThreads(1);
+  parallel.setNumberOfThreads(0);
+
+  std::vector<OrbExtractor::Keypoint> keypoints1, keypoints2;
+  std::vector<uint8_t> descriptors1, descriptors2;
+  sequential.detectAndCompute(image, &keypoints1, &descriptors1);
+  parallel.detectAndCompute(image, &keypoints2, &descriptors2);
+
+  ASSERT_EQ(keypoints1.size(), keypoints2.size());
+  EXPECT_EQ(descriptors1, descriptors2);
+}
+
+TEST(orb_extractor, small_images_have_no_keypoints) {
+  std::vector<OrbExtractor::Keypoint> keypoints;
+  std::vector<uint8_t> descriptors;
+  OrbExtractor().detectAndCompute(randomTexture(Size(30, 30), 2), &keypoints, &descriptors);
+  EXPECT_TRUE(keypoints.empty());
+  EXPECT_TRUE(descriptors.empty());
+}
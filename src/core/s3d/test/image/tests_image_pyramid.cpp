@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+
+#include "s3d/image/image_pyramid.h"
+
+#include <random>
+
+using s3d::Image;
+using s3d::ImagePyramid;
+using s3d::Size;
+
+namespace {
+
+Image<uint8_t> randomImage(Size size, unsigned int seed) {
+  std::mt19937 mt(seed);
+  std::uniform_int_distribution<int> dist(0, 255);
+  Image<uint8_t> image(size);
+  for (int i = 0; i < size.getArea(); ++i) {
+    image[i] = static_cast<uint8_t>(dist(mt));
+  }
+  return image;
+}
+
+uint8_t pixel(const ImagePyramid& pyramid, int level, int x, int y) {
+  return pyramid.levelData(level)[y * static_cast<int>(pyramid.levelStride(level)) + x];
+}
+
+}  // namespace
+
+TEST(image_pyramid, level_sizes_are_halved) {
+  ImagePyramid pyramid;
+  pyramid.build(Image<uint8_t>(Size(101, 40), 0), 3);
+
+  ASSERT_EQ(pyramid.nbLevels(), 3);
+  EXPECT_EQ(pyramid.levelSize(0), Size(101, 40));
+  EXPECT_EQ(pyramid.levelSize(1), Size(50, 20));
+  EXPECT_EQ(pyramid.levelSize(2), Size(25, 10));
+  EXPECT_FLOAT_EQ(ImagePyramid::levelScale(2), 0.25f);
+}
+
+TEST(image_pyramid, stops_before_too_small_levels) {
+  ImagePyramid pyramid;
+  pyramid.build(Image<uint8_t>(Size(8, 5), 0), 10);
+  EXPECT_EQ(pyramid.nbLevels(), 2);
+}
+
+TEST(image_pyramid, levels_are_rounded_2x2_means) {
+  // wide enough to go through vectorized and scalar paths
+  auto image = randomImage(Size(75, 9), 0);
+
+  ImagePyramid pyramid;
+  pyramid.build(image, 2);
+
+  const Size size = pyramid.levelSize(1);
+  for (int y = 0; y < size.getHeight(); ++y) {
+    for (int x = 0; x < size.getWidth(); ++x) {
+      int sum = image(2 * y, 2 * x) + image(2 * y, 2 * x + 1) + image(2 * y + 1, 2 * x) +
+                image(2 * y + 1, 2 * x + 1);
+      EXPECT_EQ(pixel(pyramid, 1, x, y), (sum + 2) / 4);
+    }
+  }
+}
+
+TEST(image_pyramid, border_replicates_edge_pixels) {
+  auto image = randomImage(Size(10, 6), 1);
+
+  ImagePyramid pyramid;
+  pyramid.build(image, 1, 3);
+
+  EXPECT_EQ(pyramid.border(), 3);
+  EXPECT_EQ(pyramid.levelStride(0), 16u);
+  EXPECT_EQ(pixel(pyramid, 0, 4, 2), image(2, 4));
+  EXPECT_EQ(pixel(pyramid, 0, -3, 2), image(2, 0));
+  EXPECT_EQ(pixel(pyramid, 0, 12, 5), image(5, 9));
+  EXPECT_EQ(pixel(pyramid, 0, -1, -3), image(0, 0));
+  EXPECT_EQ(pixel(pyramid, 0, 11, 8), image(5, 9));
+}
+
+TEST(image_pyramid, rebuild_with_other_size) {
+  ImagePyramid pyramid;
+  pyramid.build(Image<uint8_t>(Size(64, 64), 10), 3);
+  pyramid.build(Image<uint8_t>(Size(20, 10), 20), 3);
+
+  ASSERT_EQ(pyramid.nbLevels(), 3);
+  EXPECT_EQ(pyramid.levelSize(1), Size(10, 5));
+  EXPECT_EQ(pyramid.levelSize(2), Size(5, 2));
+  EXPECT_EQ(pixel(pyramid, 1, 9, 4), 20);
+}
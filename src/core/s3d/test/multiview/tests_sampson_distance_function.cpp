@@ -2,6 +2,7 @@
 
 #include "s3d/multiview/sampson_distance_function.h"
 #include "s3d/multiview/stan_fundamental_matrix_solver.h"
+#include "s3d/robust/lmeds.h"
 
 using s3d::SampsonDistanceFunction;
 using s3d::StanAlignment;
@@ -128,3 +129,55 @@ TEST(sampson_distance_function, real_image_features_overkill_integration) {
   EXPECT_NEAR(distances[distances.size() - 2], 0.91, 0.01);
   EXPECT_NEAR(distances[distances.size() - 1], 0.25, 0.01);
 }
+
+TEST(sampson_distance_function, soa_kernel_matches_per_sample_distance) {
+  StanAlignment alignment{0.01, -0.02, 0.005, 3.0, 1e-5, 2e-5, 1e-5};
+
+  std::vector<Eigen::Vector3d> x, xp;
+  for (int i = 0; i < 23; ++i) {
+    x.emplace_back((i * 37) % 1900 - 950.0, (i * 53) % 1060 - 530.0, 1.0);
+    xp.emplace_back((i * 41) % 1900 - 950.0, (i * 29) % 1060 - 530.0, 1.0);
+  }
+
+  std::vector<double> expected(x.size());
+  SampsonDistanceFunction::ComputeDistance(x, xp, alignment, &expected);
+
+  // whole range, then an unaligned range leaving the other distances untouched
+  SampsonDistanceFunction::SoaSamples soa(x, xp);
+  std::vector<double> distances(x.size(), -1.0);
+  SampsonDistanceFunction::ComputeDistance(soa.view(), alignment, 0, x.size(), distances.data());
+  for (size_t i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(distances[i], expected[i], 1e-9 * (1.0 + expected[i]));
+  }
+
+  std::fill(distances.begin(), distances.end(), -1.0);
+  SampsonDistanceFunction::ComputeDistance(soa.view(), alignment, 3, 18, distances.data());
+  for (size_t i = 0; i < x.size(); ++i) {
+    if (i < 3 || i >= 18) {
+      EXPECT_EQ(distances[i], -1.0);
+    } else {
+      EXPECT_NEAR(distances[i], expected[i], 1e-9 * (1.0 + expected[i]));
+    }
+  }
+}
+
+TEST(sampson_distance_function, estimators_borrow_soa_samples) {
+  std::vector<Eigen::Vector3d> x, xp;
+  for (int i = 0; i < 40; ++i) {
+    x.emplace_back((i * 37) % 1900 - 950.0, (i * 53) % 1060 - 530.0, 1.0);
+    xp.emplace_back(x.back().x() - (i % 7) * 3.0, x.back().y() + (i % 5 == 0 ? 40.0 : 1.5), 1.0);
+  }
+  const SampsonDistanceFunction::SoaSamples soa(x, xp);
+
+  auto params = s3d::StanFundamentalMatrixSolver::RobustParameters();
+  params.seed = 0;
+  using Lmeds = s3d::robust::Lmeds<s3d::StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+  Lmeds copied(params);
+  Lmeds borrowed(params);
+  const auto expected = copied(x, xp);
+  const auto alignment = borrowed(soa.view());
+
+  EXPECT_EQ(alignment.f_a_x, expected.f_a_x);
+  EXPECT_EQ(alignment.ch_y, expected.ch_y);
+  EXPECT_EQ(borrowed.getBestInlierSamples(), copied.getBestInlierSamples());
+}
@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+
+#include "s3d/multiview/stan_batch_estimator.h"
+
+#include "stan_synthetic_correspondences.h"
+
+using s3d::MatchFinder;
+using s3d::StanAlignment;
+using s3d::StanBatchEstimator;
+
+constexpr int WIDTH = 1920;
+constexpr int HEIGHT = 1080;
+
+namespace {
+
+StanAlignment frameAlignment(size_t frame) {
+  const double t = static_cast<double>(frame);
+  return {0.002 + 1e-4 * t, 0.001, 0.003 - 1e-4 * t, 1.5, 1e-6, 0.0, 0.0};
+}
+
+}  // namespace
+
+TEST(stan_batch_estimator, estimates_every_frame) {
+  constexpr size_t nbFrames = 12;
+  std::vector<MatchFinder::Matches> frames;
+  for (size_t i = 0; i < nbFrames; ++i) {
+    frames.push_back(
+        s3d::stan_synthetic_matches(frameAlignment(i), 300, 0.0, static_cast<unsigned int>(i)));
+  }
+  // not enough correspondences
+  frames[5].resize(2);
+  frames[5][0].resize(3);
+  frames[5][1].resize(3);
+
+  s3d::robust::Parameters params;
+  params.nbTrials = 500;
+  params.seed = 1;
+
+  StanBatchEstimator estimator(s3d::Size(WIDTH, HEIGHT));
+  estimator.setParameters(params);
+  auto results = estimator.estimate(frames);
+
+  ASSERT_EQ(results.size(), nbFrames);
+  for (size_t i = 0; i < nbFrames; ++i) {
+    if (i == 5) {
+      EXPECT_FALSE(results[i].valid);
+      continue;
+    }
+    ASSERT_TRUE(results[i].valid);
+    // LMedS inliers: distances up to the median
+    EXPECT_EQ(results[i].nbInliers, 150);
+    const auto gold = frameAlignment(i);
+    EXPECT_NEAR(results[i].alignment.ch_y, gold.ch_y, 1e-6);
+    EXPECT_NEAR(results[i].alignment.a_z, gold.a_z, 1e-6);
+    EXPECT_NEAR(results[i].alignment.a_f, gold.a_f, 1e-6);
+    EXPECT_NEAR(results[i].alignment.f_a_x, gold.f_a_x, 1e-4);
+    EXPECT_NEAR(results[i].alignment.a_y_f, gold.a_y_f, 1e-9);
+  }
+
+  // same seed, same results whatever the number of threads
+  estimator.setNumberOfThreads(1);
+  auto sequentialResults = estimator.estimate(frames);
+  for (size_t i = 0; i < nbFrames; ++i) {
+    EXPECT_EQ(sequentialResults[i].nbInliers, results[i].nbInliers);
+    EXPECT_EQ(sequentialResults[i].alignment.ch_y, results[i].alignment.ch_y);
+  }
+}
+
+TEST(stan_batch_estimator, smooth_track_averages_valid_neighbours) {
+  std::vector<StanBatchEstimator::FrameResult> results(4);
+  for (size_t i = 0; i < results.size(); ++i) {
+    results[i].valid = true;
+    results[i].nbInliers = 100;
+    results[i].alignment.ch_y = static_cast<double>(i);
+  }
+  results[1].valid = false;
+  results[1].alignment.ch_y = 100.0;
+  results[2].nbInliers = 300;
+
+  auto track = StanBatchEstimator::smoothTrack(results, 1);
+
+  ASSERT_EQ(track.size(), results.size());
+  EXPECT_DOUBLE_EQ(track[0].ch_y, 0.0);
+  EXPECT_DOUBLE_EQ(track[1].ch_y, (0.0 * 100 + 2.0 * 300) / 400);
+  EXPECT_DOUBLE_EQ(track[2].ch_y, (2.0 * 300 + 3.0 * 100) / 400);
+  EXPECT_DOUBLE_EQ(track[3].ch_y, (2.0 * 300 + 3.0 * 100) / 400);
+
+  // nothing valid around: own alignment
+  auto alone = StanBatchEstimator::smoothTrack({results[1]}, 2);
+  EXPECT_DOUBLE_EQ(alone[0].ch_y, 100.0);
+}
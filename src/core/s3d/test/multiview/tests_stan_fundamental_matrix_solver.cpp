@@ -174,3 +174,76 @@ TEST(stan_fundamental_matrix_solver, real_image_data_overkill_integration) {
   EXPECT_NEAR(res.a_x_f, 0.00, 0.01);
   EXPECT_NEAR(res.ch_z_f, 0.00, 0.01);
 }
+
+TEST(stan_fundamental_matrix_solver, normal_equations_match_qr_least_squares) {
+  StanAlignment alignment{0.01, -0.02, 0.005, 3.0, 1e-5, 0.0, 0.0};
+  Eigen::Matrix3d F = StanFundamentalMatrixSolver::FundamentalMatrixFromAlignment(alignment);
+
+  // centered pixel coordinates, right points on their epipolar line plus noise
+  std::vector<Eigen::Vector3d> x, xp;
+  for (int i = 0; i < 500; ++i) {
+    Eigen::Vector3d pt((i * 37) % 1900 - 950.0, (i * 53) % 1060 - 530.0, 1.0);
+    Eigen::Vector3d line = F * pt;
+    double xRight = pt.x() - 20.0 + (i % 40);
+    double yRight = -(line.x() * xRight + line.z()) / line.y() + 0.1 * ((i % 7) - 3);
+    x.push_back(pt);
+    xp.emplace_back(xRight, yRight, 1.0);
+  }
+
+  Eigen::MatrixXd A;
+  Eigen::VectorXd b;
+  std::tie(A, b) = StanFundamentalMatrixSolver::BuildEquationSystem(x, xp);
+  Eigen::VectorXd expected = A.colPivHouseholderQr().solve(b);
+
+  auto res = StanFundamentalMatrixSolver::ComputeModel(x, xp);
+
+  EXPECT_NEAR(res.ch_y, expected[0], 1e-9);
+  EXPECT_NEAR(res.a_z, expected[1], 1e-9);
+  EXPECT_NEAR(res.a_f, expected[2], 1e-9);
+  EXPECT_NEAR(res.f_a_x, expected[3], 1e-6);
+  EXPECT_NEAR(res.a_y_f, expected[4], 1e-12);
+}
+
+TEST(stan_fundamental_matrix_solver, minimal_sample_solves_exactly) {
+  std::vector<Eigen::Vector3d> x, xp;
+  x.emplace_back(-300.0, -200.0, 1.0);
+  x.emplace_back(250.0, -150.0, 1.0);
+  x.emplace_back(-100.0, 180.0, 1.0);
+  x.emplace_back(400.0, 220.0, 1.0);
+  x.emplace_back(20.0, -30.0, 1.0);
+  xp.emplace_back(-310.0, -198.0, 1.0);
+  xp.emplace_back(235.0, -147.0, 1.0);
+  xp.emplace_back(-118.0, 183.0, 1.0);
+  xp.emplace_back(382.0, 221.0, 1.0);
+  xp.emplace_back(5.0, -29.0, 1.0);
+
+  Eigen::MatrixXd A;
+  Eigen::VectorXd b;
+  std::tie(A, b) = StanFundamentalMatrixSolver::BuildEquationSystem(x, xp);
+
+  auto res = StanFundamentalMatrixSolver::ComputeModel(x, xp);
+  Eigen::VectorXd solution(5);
+  solution << res.ch_y, res.a_z, res.a_f, res.f_a_x, res.a_y_f;
+
+  EXPECT_LT((A * solution - b).norm(), 1e-9);
+}
+
+TEST(stan_fundamental_matrix_solver, scaled_alignment_keeps_epipolar_constraint) {
+  const StanAlignment a{0.01, -0.02, 0.005, 3.0, 1e-5, 2e-5, 3e-5};
+  constexpr double scale = 2.0;
+  const auto scaled = StanFundamentalMatrixSolver::ScaledAlignment(a, scale);
+  EXPECT_DOUBLE_EQ(scaled.ch_y, a.ch_y);
+  EXPECT_DOUBLE_EQ(scaled.f_a_x, 6.0);
+
+  // the constraint only changes by the factor F'(2, 1) is normalized with
+  const auto F = StanFundamentalMatrixSolver::FundamentalMatrixFromAlignment(a);
+  const auto FScaled = StanFundamentalMatrixSolver::FundamentalMatrixFromAlignment(scaled);
+  const Eigen::Vector3d x(-120.0, 45.0, 1.0), xp(-131.0, 47.0, 1.0);
+  const Eigen::Vector3d xScaled(scale * x.x(), scale * x.y(), 1.0);
+  const Eigen::Vector3d xpScaled(scale * xp.x(), scale * xp.y(), 1.0);
+  EXPECT_NEAR(xpScaled.dot(FScaled * xScaled), scale * xp.dot(F * x), 1e-9);
+
+  const auto back = StanFundamentalMatrixSolver::ScaledAlignment(scaled, 1.0 / scale);
+  EXPECT_DOUBLE_EQ(back.a_y_f, a.a_y_f);
+  EXPECT_DOUBLE_EQ(back.f_a_x, a.f_a_x);
+}
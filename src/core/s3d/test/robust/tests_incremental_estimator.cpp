@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+
+#include "s3d/multiview/sampson_distance_function.h"
+#include "s3d/multiview/stan_fundamental_matrix_solver.h"
+#include "s3d/robust/incremental_estimator.h"
+
+#include "stan_synthetic_correspondences.h"
+
+using s3d::SampsonDistanceFunction;
+using s3d::StanAlignment;
+using s3d::StanFundamentalMatrixSolver;
+using s3d::robust::IncrementalEstimator;
+using s3d::robust::Parameters;
+
+using Estimator = IncrementalEstimator<StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+
+namespace {
+
+Parameters parameters() {
+  auto params = StanFundamentalMatrixSolver::RobustParameters();
+  params.seed = 0;
+  return params;
+}
+
+}  // namespace
+
+TEST(incremental_estimator, locked_off_rig_is_only_refined) {
+  const StanAlignment gold{0.002, 0.001, 0.003, 1.5, 1e-6, 0.0, 0.0};
+  Estimator estimator(parameters());
+
+  for (unsigned int frame = 0; frame < 10; ++frame) {
+    auto samples = s3d::stan_synthetic_correspondences(gold, 300, 0.2, frame);
+    const auto model = estimator(samples.left, samples.right);
+
+    EXPECT_EQ(estimator.wasWarmStarted(), frame > 0);
+    EXPECT_NEAR(model.ch_y, gold.ch_y, 5e-3);
+    EXPECT_NEAR(model.a_z, gold.a_z, 1e-3);
+    EXPECT_NEAR(model.f_a_x, gold.f_a_x, 0.1);
+    EXPECT_GE(estimator.getBestInlierSamples().first.size(), 200);
+  }
+  EXPECT_EQ(estimator.getNbFullEstimations(), 1);
+  EXPECT_EQ(estimator.getNbWarmStarts(), 9);
+}
+
+TEST(incremental_estimator, moved_rig_is_estimated_again) {
+  const StanAlignment before{0.002, 0.001, 0.003, 1.5, 1e-6, 0.0, 0.0};
+  const StanAlignment after{0.002, 0.001, 0.003, 12.0, 1e-6, 0.0, 0.0};
+  Estimator estimator(parameters());
+
+  auto samples = s3d::stan_synthetic_correspondences(before, 300, 0.2, 0);
+  estimator(samples.left, samples.right);
+
+  samples = s3d::stan_synthetic_correspondences(after, 300, 0.2, 1);
+  const auto model = estimator(samples.left, samples.right);
+  EXPECT_FALSE(estimator.wasWarmStarted());
+  EXPECT_NEAR(model.f_a_x, after.f_a_x, 0.1);
+
+  // a scene cut forgets the model
+  estimator.reset();
+  samples = s3d::stan_synthetic_correspondences(after, 300, 0.2, 2);
+  estimator(samples.left, samples.right);
+  EXPECT_FALSE(estimator.wasWarmStarted());
+  EXPECT_EQ(estimator.getNbFullEstimations(), 3);
+}
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+
+#include "s3d/robust/inlier_mask.h"
+
+#include <random>
+
+using s3d::robust::InlierMask;
+
+std::vector<double> randomDistances(size_t size, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(0.0, 2.0);
+  std::vector<double> distances(size);
+  for (auto& distance : distances) {
+    distance = distribution(generator);
+  }
+  return distances;
+}
+
+TEST(inlier_mask, fill_matches_threshold_comparison) {
+  constexpr double threshold = 1.0;
+  for (size_t size : {0, 1, 3, 63, 64, 65, 1000}) {
+    auto distances = randomDistances(size, static_cast<unsigned int>(size));
+    distances.push_back(threshold);  // on the threshold is an inlier
+
+    InlierMask mask(distances.size());
+    size_t nbInliers = mask.fill(distances, threshold);
+
+    size_t goldNb = 0;
+    for (size_t i = 0; i < distances.size(); ++i) {
+      EXPECT_EQ(mask[i], distances[i] <= threshold);
+      goldNb += distances[i] <= threshold ? 1 : 0;
+    }
+    EXPECT_EQ(nbInliers, goldNb);
+    EXPECT_EQ(mask.count(), goldNb);
+  }
+}
+
+TEST(inlier_mask, for_each_set_visits_set_bits_in_order) {
+  InlierMask mask(200);
+  const std::vector<size_t> gold = {0, 5, 63, 64, 127, 128, 199};
+  for (auto i : gold) {
+    mask.set(i, true);
+  }
+  mask.set(5, false);
+  mask.set(5, true);
+
+  std::vector<size_t> visited;
+  mask.forEachSet([&visited](size_t i) { visited.push_back(i); });
+  EXPECT_EQ(visited, gold);
+}
+
+TEST(inlier_mask, swap_exchanges_bits_without_copy) {
+  InlierMask a(100), b(100);
+  a.set(3, true);
+  b.set(42, true);
+  const uint64_t* wordsOfA = a.words().data();
+
+  a.swap(b);
+
+  EXPECT_TRUE(a[42]);
+  EXPECT_FALSE(a[3]);
+  EXPECT_TRUE(b[3]);
+  EXPECT_EQ(b.words().data(), wordsOfA);
+}
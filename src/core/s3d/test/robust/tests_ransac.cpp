@@ -1,10 +1,17 @@
 #include "gtest/gtest.h"
 
+#include "s3d/robust/lmeds.h"
+#include "s3d/robust/prosac_sampler.h"
 #include "s3d/robust/ransac.h"
 #include "s3d/robust/estimation_algorithm_traits.h"
+#include "s3d/robust/verification.h"
 
 #include "s3d/multiview/stan_fundamental_matrix_solver.h"
 
+#include <random>
+
+using s3d::robust::Lmeds;
+using s3d::robust::ProsacSampler;
 using s3d::robust::Ransac;
 using s3d::robust::Trials;
 using s3d::robust::Parameters;
@@ -90,6 +97,405 @@ TEST(ransac, line_solver) {
   EXPECT_DOUBLE_EQ(line.C, 0);
 }
 
+TEST(ransac, line_solver_parallel) {
+  Parameters params{};
+  params.nbTrials = 100;
+  params.nbThreads = 4;
+  Ransac<LineSolver, LeastSquareDistanceFunction> ransac(params);
+
+  using SampleType = LineSolver::SampleType;
+  auto x = std::vector<SampleType>{0, 1, 2, 3, 4, 5, 6, 7, 8, 1, 3, 4, 6, 8};
+  auto y = std::vector<SampleType>{0, 1, 2, 3, 4, 5, 6, 7, 8, 5, 6, 1, 1, 3};
+
+  auto line = ransac(x, y);
+
+  EXPECT_DOUBLE_EQ(line.A, -line.B);
+  EXPECT_DOUBLE_EQ(line.C, 0);
+}
+
+TEST(ransac, same_seed_same_result) {
+  Parameters params{};
+  params.nbTrials = 50;
+  params.distanceThreshold = 0.5;
+  params.seed = 42;
+  params.nbThreads = 3;
+
+  // noisy line y = 2x + 1 with outliers every 4 points
+  using SampleType = LineSolver::SampleType;
+  std::vector<SampleType> x, y;
+  for (int i = 0; i < 40; ++i) {
+    x.push_back(i);
+    y.push_back(i % 4 == 0 ? 50.0 - i : 2.0 * i + 1.0 + 0.1 * (i % 3));
+  }
+
+  Ransac<LineSolver, LeastSquareDistanceFunction> ransac1(params);
+  Ransac<LineSolver, LeastSquareDistanceFunction> ransac2(params);
+  auto line1 = ransac1(x, y);
+  auto line2 = ransac2(x, y);
+
+  EXPECT_EQ(line1.A, line2.A);
+  EXPECT_EQ(line1.B, line2.B);
+  EXPECT_EQ(line1.C, line2.C);
+  EXPECT_EQ(ransac1.getBestInlierSamples(), ransac2.getBestInlierSamples());
+}
+
+TEST(ransac, inlier_mask_indexes_inlier_samples) {
+  Parameters params{};
+  params.nbTrials = 50;
+  params.distanceThreshold = 0.5;
+  params.seed = 7;
+
+  // line y = 2x + 1 with outliers every 4 points
+  using SampleType = LineSolver::SampleType;
+  std::vector<SampleType> x, y;
+  for (int i = 0; i < 40; ++i) {
+    x.push_back(i);
+    y.push_back(i % 4 == 0 ? 50.0 - i : 2.0 * i + 1.0);
+  }
+
+  Ransac<LineSolver, LeastSquareDistanceFunction> ransac(params);
+  ransac(x, y);
+
+  std::vector<SampleType> maskedX, maskedY;
+  ransac.getBestInlierMask().forEachSet([&](size_t i) {
+    maskedX.push_back(x[i]);
+    maskedY.push_back(y[i]);
+  });
+  EXPECT_FALSE(maskedX.empty());
+  EXPECT_EQ(ransac.getBestInlierSamples(), std::make_pair(maskedX, maskedY));
+}
+
+TEST(lmeds, same_seed_same_result_parallel) {
+  Parameters params{};
+  params.nbTrials = 50;
+  params.seed = 7;
+  params.nbThreads = 4;
+
+  using SampleType = LineSolver::SampleType;
+  auto x = std::vector<SampleType>{0, 1, 2, 3, 4, 5, 6, 7, 8, 1, 3, 4, 6, 8};
+  auto y = std::vector<SampleType>{0, 1, 2, 3, 4, 5, 6, 7, 8, 5, 6, 1, 1, 3};
+
+  Lmeds<LineSolver, LeastSquareDistanceFunction> lmeds1(params);
+  Lmeds<LineSolver, LeastSquareDistanceFunction> lmeds2(params);
+  auto line1 = lmeds1(x, y);
+  auto line2 = lmeds2(x, y);
+
+  EXPECT_EQ(line1.A, line2.A);
+  EXPECT_EQ(line1.B, line2.B);
+  EXPECT_EQ(line1.C, line2.C);
+}
+
+class AbsoluteDistanceFunction {
+ public:
+  using SampleType = LineSolver::SampleType;
+
+  static void ComputeDistance(const std::vector<SampleType>& x,
+                              const std::vector<SampleType>& y,
+                              const LineSolver::ModelType& model,
+                              std::vector<double>* distances) {
+    for (size_t i = 0; i < distances->size(); i++) {
+      (*distances)[i] = std::abs(model.A * x[i] + model.B * y[i] - model.C);
+    }
+  }
+
+  struct SampleDistance {
+    explicit SampleDistance(const LineSolver::ModelType& model) : model{model} {}
+
+    double operator()(SampleType x, SampleType y) const {
+      return std::abs(model.A * x + model.B * y - model.C);
+    }
+
+    LineSolver::ModelType model;
+  };
+};
+
+TEST(lmeds, stops_early_when_most_samples_fit) {
+  Parameters params{};
+  params.nbTrials = 500;
+  params.distanceThreshold = 0.01;
+  params.seed = 2;
+
+  // 90% inliers: the 50% outliers bound of LMedS is about 40 trials
+  using SampleType = LineSolver::SampleType;
+  std::vector<SampleType> x, y;
+  for (int i = 0; i < 200; ++i) {
+    x.push_back(i);
+    y.push_back(i % 10 != 0 ? 0.5 * i + 2.0 : 1000.0 - 3.0 * i);
+  }
+
+  Lmeds<LineSolver, AbsoluteDistanceFunction> lmeds(params);
+  auto line = lmeds(x, y);
+
+  EXPECT_NEAR(-line.A / line.B, 0.5, 1e-9);
+  EXPECT_LT(lmeds.getTotalNumberOfIterations(), 20);
+}
+
+// outliers only: the number of trials is never lowered
+std::pair<std::vector<double>, std::vector<double>> randomPoints(size_t nb) {
+  std::vector<double> x, y;
+  std::mt19937 generator(4);
+  std::uniform_real_distribution<double> coordinate(-1000.0, 1000.0);
+  for (size_t i = 0; i < nb; ++i) {
+    x.push_back(coordinate(generator));
+    y.push_back(coordinate(generator));
+  }
+  return {x, y};
+}
+
+TEST(ransac, parallel_batches_do_not_exceed_nb_trials) {
+  Parameters params{};
+  params.nbTrials = 10;
+  params.distanceThreshold = 1e-6;
+  params.seed = 1;
+  params.nbThreads = 3;
+
+  auto points = randomPoints(100);
+  Ransac<LineSolver, AbsoluteDistanceFunction> ransac(params);
+  ransac(points.first, points.second);
+
+  // + 1 for the last check of the sequential loop
+  EXPECT_EQ(ransac.getTotalNumberOfIterations(), params.nbTrials + 1);
+}
+
+TEST(lmeds, parallel_batches_do_not_exceed_nb_trials) {
+  Parameters params{};
+  params.nbTrials = 10;
+  params.distanceThreshold = 1e-6;
+  params.seed = 1;
+  params.nbThreads = 3;
+
+  auto points = randomPoints(100);
+  Lmeds<LineSolver, AbsoluteDistanceFunction> lmeds(params);
+  lmeds(points.first, points.second);
+
+  EXPECT_EQ(lmeds.getTotalNumberOfIterations(), params.nbTrials + 1);
+}
+
+TEST(ransac, prosac_needs_less_iterations_on_ranked_samples) {
+  Parameters params{};
+  params.nbTrials = 10000;
+  params.distanceThreshold = 0.01;
+  params.seed = 3;
+
+  // 60% outliers, ranked samples: best qualities are mostly inliers
+  using SampleType = LineSolver::SampleType;
+  std::vector<SampleType> x, y;
+  for (int i = 0; i < 200; ++i) {
+    bool isInlier = i < 60 ? i % 5 != 0 : i % 4 == 0;
+    x.push_back(i);
+    y.push_back(isInlier ? 0.5 * i + 2.0 : 1000.0 - 3.0 * i + (i % 7) * 11.0);
+  }
+
+  Ransac<LineSolver, AbsoluteDistanceFunction> uniform(params);
+  Ransac<LineSolver, AbsoluteDistanceFunction, ProsacSampler<LineSolver, AbsoluteDistanceFunction>>
+      prosac(params);
+  auto uniformLine = uniform(x, y);
+  auto prosacLine = prosac(x, y);
+
+  EXPECT_NEAR(prosacLine.A / prosacLine.B, uniformLine.A / uniformLine.B, 1e-9);
+  EXPECT_NEAR(-prosacLine.A / prosacLine.B, 0.5, 1e-9);
+  EXPECT_EQ(prosac.getBestInlierSamples().first.size(), 83);
+  EXPECT_LT(prosac.getTotalNumberOfIterations(), uniform.getTotalNumberOfIterations());
+}
+
+TEST(ransac, sprt_evaluates_less_distances_with_many_outliers) {
+  Parameters params{};
+  params.nbTrials = 100000;
+  params.distanceThreshold = 0.01;
+  params.seed = 5;
+
+  // 85% outliers
+  using SampleType = LineSolver::SampleType;
+  std::vector<SampleType> x, y;
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> outlier(-1000.0, 1000.0);
+  for (int i = 0; i < 2000; ++i) {
+    x.push_back(i);
+    y.push_back(i % 20 < 3 ? 0.5 * i + 2.0 : outlier(generator));
+  }
+
+  using Distance = AbsoluteDistanceFunction;
+  Ransac<LineSolver, Distance> full(params);
+  Ransac<LineSolver, Distance, s3d::robust::ModelSampler<LineSolver, Distance>,
+         s3d::robust::SprtVerification<Distance>>
+      sprt(params);
+  auto fullLine = full(x, y);
+  auto sprtLine = sprt(x, y);
+
+  EXPECT_NEAR(-fullLine.A / fullLine.B, 0.5, 1e-9);
+  EXPECT_NEAR(-sprtLine.A / sprtLine.B, 0.5, 1e-9);
+  EXPECT_EQ(sprt.getBestInlierSamples().first.size(), full.getBestInlierSamples().first.size());
+  EXPECT_LT(3 * sprt.getNbDistanceEvaluations(), full.getNbDistanceEvaluations());
+}
+
+TEST(sprt_verification, hypotheses_start_from_different_blocks) {
+  using Distance = AbsoluteDistanceFunction;
+  using Verifier = s3d::robust::SprtVerification<Distance>;
+
+  // a line far from every sample is rejected after a few blocks
+  std::vector<double> x, y;
+  for (int i = 0; i < 400; ++i) {
+    x.push_back(i);
+    y.push_back(0.5 * i + 2.0);
+  }
+  const s3d::robust::DistanceSamples<Distance> samples(x, y);
+  const Line farLine{0.0, 1.0, -1000.0};
+  Verifier verifier(x.size(), 0.01, 3);
+
+  auto testedSamples = [&] {
+    std::vector<double> distances(x.size(), -1.0);
+    EXPECT_FALSE(verifier.verify(samples, farLine, &distances));
+    std::vector<size_t> tested;
+    for (size_t i = 0; i < distances.size(); ++i) {
+      if (distances[i] >= 0.0) {
+        tested.push_back(i);
+      }
+    }
+    return tested;
+  };
+
+  EXPECT_NE(testedSamples(), testedSamples());
+}
+
+// y = a * x + b, least squares on any number of samples
+struct Regression {
+  double a;
+  double b;
+};
+
+class RegressionSolver {
+ public:
+  using SampleType = double;
+  using ModelType = Regression;
+
+  static ModelType ComputeModel(const std::vector<SampleType>& x,
+                                const std::vector<SampleType>& y) {
+    assert(x.size() >= 2);
+    double meanX = 0.0, meanY = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+      meanX += x[i];
+      meanY += y[i];
+    }
+    meanX /= x.size();
+    meanY /= y.size();
+
+    double covXY = 0.0, varX = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+      covXY += (x[i] - meanX) * (y[i] - meanY);
+      varX += (x[i] - meanX) * (x[i] - meanX);
+    }
+    const double a = covXY / varX;
+    return {a, meanY - a * meanX};
+  }
+};
+
+namespace s3d {
+namespace robust {
+template <>
+struct estimation_algorithm_traits<RegressionSolver> {
+  using SampleType = RegressionSolver::SampleType;
+  using ModelType = RegressionSolver::ModelType;
+  enum { MIN_NB_SAMPLES = 2 };
+};
+}  // namespace robust
+}  // namespace s3d
+
+class RegressionDistanceFunction {
+ public:
+  using SampleType = RegressionSolver::SampleType;
+
+  static void ComputeDistance(const std::vector<SampleType>& x,
+                              const std::vector<SampleType>& y,
+                              const Regression& model,
+                              std::vector<double>* distances) {
+    for (size_t i = 0; i < distances->size(); i++) {
+      (*distances)[i] = std::abs(y[i] - model.a * x[i] - model.b);
+    }
+  }
+};
+
+// y = 0.5x + 2 with uniform noise in [-0.5, 0.5], 60% outliers
+void noisyRegressionSamples(std::vector<double>* x, std::vector<double>* y) {
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<double> position(0.0, 100.0);
+  std::uniform_real_distribution<double> noise(-0.5, 0.5);
+  std::uniform_real_distribution<double> outlier(-100.0, 150.0);
+  for (int i = 0; i < 500; ++i) {
+    x->push_back(position(generator));
+    y->push_back(i % 5 < 2 ? 0.5 * x->back() + 2.0 + noise(generator) : outlier(generator));
+  }
+}
+
+TEST(ransac, local_optimization_needs_less_iterations) {
+  Parameters params{};
+  params.nbTrials = 10000;
+  params.distanceThreshold = 0.6;
+  params.seed = 4;
+
+  std::vector<double> x, y;
+  noisyRegressionSamples(&x, &y);
+
+  Ransac<RegressionSolver, RegressionDistanceFunction> plain(params);
+  params.localOptimization = true;
+  Ransac<RegressionSolver, RegressionDistanceFunction> lo(params);
+  plain(x, y);
+  auto loModel = lo(x, y);
+
+  EXPECT_NEAR(loModel.a, 0.5, 0.01);
+  EXPECT_NEAR(loModel.b, 2.0, 0.2);
+  EXPECT_GT(lo.getNbLocallyOptimizedModels(), 0);
+  EXPECT_GE(lo.getBestInlierSamples().first.size(), plain.getBestInlierSamples().first.size());
+  EXPECT_LT(lo.getTotalNumberOfIterations(), plain.getTotalNumberOfIterations());
+}
+
+TEST(ransac, msac_with_local_optimization_parallel) {
+  Parameters params{};
+  params.nbTrials = 10000;
+  params.distanceThreshold = 0.6;
+  params.seed = 4;
+  params.nbThreads = 4;
+  params.scoring = s3d::robust::Scoring::Msac;
+  params.localOptimization = true;
+
+  std::vector<double> x, y;
+  noisyRegressionSamples(&x, &y);
+
+  Ransac<RegressionSolver, RegressionDistanceFunction> msac1(params);
+  Ransac<RegressionSolver, RegressionDistanceFunction> msac2(params);
+  auto model1 = msac1(x, y);
+  auto model2 = msac2(x, y);
+
+  EXPECT_NEAR(model1.a, 0.5, 0.01);
+  EXPECT_NEAR(model1.b, 2.0, 0.2);
+  EXPECT_EQ(model1.a, model2.a);
+  EXPECT_EQ(model1.b, model2.b);
+}
+
+TEST(inliers_msac, same_count_lower_residuals_is_better) {
+  s3d::robust::InliersMSAC inliers(4, 1.0);
+
+  inliers.updateCurrent({0.9, 0.9, 5.0, 5.0});
+  inliers.updateBest();
+  EXPECT_TRUE(inliers.wereLastBest());
+
+  inliers.updateCurrent({0.1, 0.2, 5.0, 5.0});
+  inliers.updateBest();
+  EXPECT_TRUE(inliers.wereLastBest());
+  EXPECT_EQ(inliers.getBestNb(), 2);
+
+  // more inliers, but a higher cost
+  inliers.updateCurrent({0.9, 0.9, 0.9, 5.0});
+  inliers.updateBest();
+  EXPECT_FALSE(inliers.wereLastBest());
+  EXPECT_EQ(inliers.getBestNb(), 2);
+
+  // more inliers and a lower cost
+  inliers.updateCurrent({0.1, 0.2, 0.99, 5.0});
+  inliers.updateBest();
+  EXPECT_TRUE(inliers.wereLastBest());
+  EXPECT_EQ(inliers.getBestNb(), 3);
+}
+
 class FakeDistanceAllOverThreshold {
  public:
   using SampleType = LineSolver::SampleType;
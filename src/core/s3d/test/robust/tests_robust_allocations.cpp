@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+
+#include "s3d/multiview/sampson_distance_function.h"
+#include "s3d/multiview/stan_fundamental_matrix_solver.h"
+#include "s3d/robust/lmeds.h"
+#include "s3d/robust/ransac.h"
+#include "s3d/robust/verification.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+
+// every heap allocation of this test executable is counted
+namespace {
+std::atomic<size_t> nbAllocations{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++nbAllocations;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+using s3d::SampsonDistanceFunction;
+using s3d::StanFundamentalMatrixSolver;
+using s3d::robust::Lmeds;
+using s3d::robust::ModelSampler;
+using s3d::robust::NotEnoughInliersFound;
+using s3d::robust::Parameters;
+using s3d::robust::Ransac;
+using s3d::robust::Scoring;
+using s3d::robust::SprtVerification;
+
+namespace {
+
+using Sampler = ModelSampler<StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+
+Sampler::Samples randomPoints(size_t nbPoints, unsigned int seed) {
+  std::mt19937 mt(seed);
+  std::uniform_real_distribution<double> dist(-500.0, 500.0);
+  Sampler::Samples points;
+  for (size_t i = 0; i < nbPoints; ++i) {
+    points.emplace_back(dist(mt), dist(mt), 1.0);
+  }
+  return points;
+}
+
+// allocations of a whole estimation, random points keep the trials bound at nbTrials
+template <class Estimator>
+size_t allocationsDuringEstimation(Parameters params, size_t nbTrials) {
+  constexpr size_t nbPoints = 1000;
+  params.nbTrials = nbTrials;
+  params.distanceThreshold = 0.5;
+  params.seed = 0;
+  params.nbThreads = 1;
+  auto points1 = randomPoints(nbPoints, 0);
+  auto points2 = randomPoints(nbPoints, 1);
+  Estimator estimator(params);
+
+  size_t before = nbAllocations;
+  try {
+    estimator(std::move(points1), std::move(points2));
+  } catch (const NotEnoughInliersFound& /*exception*/) {
+  }
+  size_t nbAllocated = nbAllocations - before;
+
+  EXPECT_GE(estimator.getTotalNumberOfIterations(), nbTrials);
+  return nbAllocated;
+}
+
+// setup allocations do not depend on the number of trials, iterations must not allocate
+template <class Estimator>
+void expectIterationsDoNotAllocate(Parameters params, size_t nbTrials) {
+  EXPECT_EQ(allocationsDuringEstimation<Estimator>(params, nbTrials),
+            allocationsDuringEstimation<Estimator>(params, 4 * nbTrials));
+}
+
+}  // namespace
+
+TEST(robust_allocations, allocations_are_counted) {
+  size_t before = nbAllocations;
+  auto values = std::make_unique<std::vector<double>>(10);
+  EXPECT_EQ(nbAllocations - before, 2u);
+}
+
+TEST(robust_allocations, ransac_iterations_do_not_allocate) {
+  using Estimator = Ransac<StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+  expectIterationsDoNotAllocate<Estimator>(Parameters{}, 100);
+}
+
+TEST(robust_allocations, ransac_sprt_msac_lo_iterations_do_not_allocate) {
+  using Estimator = Ransac<StanFundamentalMatrixSolver, SampsonDistanceFunction, Sampler,
+                           SprtVerification<SampsonDistanceFunction>>;
+  Parameters params;
+  params.scoring = Scoring::Msac;
+  params.localOptimization = true;
+  expectIterationsDoNotAllocate<Estimator>(params, 100);
+}
+
+TEST(robust_allocations, lmeds_iterations_do_not_allocate) {
+  using Estimator = Lmeds<StanFundamentalMatrixSolver, SampsonDistanceFunction>;
+  expectIterationsDoNotAllocate<Estimator>(Parameters{}, 50);
+}
@@ -0,0 +1,74 @@
+#ifndef S3D_TEST_SUPPORT_STAN_SYNTHETIC_CORRESPONDENCES_H
+#define S3D_TEST_SUPPORT_STAN_SYNTHETIC_CORRESPONDENCES_H
+
+#include "s3d/features/match_finder.h"
+#include "s3d/multiview/stan_alignment.h"
+
+#include "s3d/utilities/eigen.h"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace s3d {
+
+/**
+ * Synthetic correspondences of a 1920x1080 stereo pair following a STAN alignment, for tests and
+ * benchmarks of the estimators (test support, not installed with the library).
+ *
+ * Disparities are uniform in [-30, 30] pixels, right rows have a gaussian noise of noiseStd pixels
+ * (none when 0) and 3 correspondences out of 10 are outliers on a random row.
+ */
+struct StanSyntheticCorrespondences {
+  // homogeneous, centered on the image
+  std::vector<Eigen::Vector3d> left;
+  std::vector<Eigen::Vector3d> right;
+};
+
+inline StanSyntheticCorrespondences stan_synthetic_correspondences(const StanAlignment& m,
+                                                                   size_t nbCorrespondences,
+                                                                   double noiseStd,
+                                                                   unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> x(-960.0, 960.0);
+  std::uniform_real_distribution<double> y(-540.0, 540.0);
+  std::uniform_real_distribution<double> disparity(-30.0, 30.0);
+  std::normal_distribution<double> noise(0.0, noiseStd > 0.0 ? noiseStd : 1.0);
+
+  StanSyntheticCorrespondences c;
+  c.left.reserve(nbCorrespondences);
+  c.right.reserve(nbCorrespondences);
+  for (size_t i = 0; i < nbCorrespondences; ++i) {
+    const double x1 = x(generator), y1 = y(generator);
+    const double x2 = x1 - disparity(generator);
+    double y2 =
+        (y1 + (x2 - x1) * m.ch_y + x2 * m.a_z - m.f_a_x + x2 * y1 * m.a_y_f) / (1.0 - m.a_f);
+    if (i % 10 < 3) {
+      y2 = y(generator);
+    } else if (noiseStd > 0.0) {
+      y2 += noise(generator);
+    }
+    c.left.emplace_back(x1, y1, 1.0);
+    c.right.emplace_back(x2, y2, 1.0);
+  }
+  return c;
+}
+
+// the same correspondences in pixels, as found by a MatchFinder
+inline MatchFinder::Matches stan_synthetic_matches(const StanAlignment& m,
+                                                   size_t nbMatches,
+                                                   double noiseStd,
+                                                   unsigned int seed) {
+  const auto c = stan_synthetic_correspondences(m, nbMatches, noiseStd, seed);
+
+  MatchFinder::Matches matches(2);
+  for (size_t i = 0; i < nbMatches; ++i) {
+    matches[0].emplace_back(c.left[i].x() + 960.0, c.left[i].y() + 540.0);
+    matches[1].emplace_back(c.right[i].x() + 960.0, c.right[i].y() + 540.0);
+  }
+  return matches;
+}
+
+}  // namespace s3d
+
+#endif  // S3D_TEST_SUPPORT_STAN_SYNTHETIC_CORRESPONDENCES_H
@@ -34,3 +34,11 @@ TEST(center, res_is_values_minus_center) {
     EXPECT_EQ(values[i], gold[i]);
   }
 }
+
+TEST(copy_if_true, copies_flagged_values) {
+  std::vector<int> values = {11, 22, 33, 44};
+  std::vector<bool> flags = {true, false, false, true};
+  std::vector<int> res;
+  s3d::copy_if_true(std::begin(values), std::end(values), back_inserter(res), flags);
+  EXPECT_EQ(res, (std::vector<int>{11, 44}));
+}
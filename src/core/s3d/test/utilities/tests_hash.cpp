@@ -0,0 +1,27 @@
+#include "gtest/gtest.h"
+
+#include "s3d/utilities/hash.h"
+
+#include <vector>
+
+TEST(hash, same_bytes_same_hash) {
+  std::vector<uint8_t> a{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  std::vector<uint8_t> b = a;
+  EXPECT_EQ(s3d::hash_bytes(a.data(), a.size()), s3d::hash_bytes(b.data(), b.size()));
+}
+
+TEST(hash, one_byte_changes_hash) {
+  std::vector<uint8_t> a{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  std::vector<uint8_t> b = a;
+  b[10] = 12;
+  EXPECT_NE(s3d::hash_bytes(a.data(), a.size()), s3d::hash_bytes(b.data(), b.size()));
+  b = a;
+  b[0] = 0;
+  EXPECT_NE(s3d::hash_bytes(a.data(), a.size()), s3d::hash_bytes(b.data(), b.size()));
+}
+
+TEST(hash, size_and_seed_change_hash) {
+  std::vector<uint8_t> zeros(16, 0);
+  EXPECT_NE(s3d::hash_bytes(zeros.data(), 15), s3d::hash_bytes(zeros.data(), 16));
+  EXPECT_NE(s3d::hash_bytes(zeros.data(), 16, 1), s3d::hash_bytes(zeros.data(), 16, 2));
+}
@@ -2,23 +2,16 @@
 
 #include "s3d/utilities/rand.h"
 
-// looks like mt gives different results on different platforms
-// so maybe this test is not optimal
-std::vector<int> getExpectedValues() {
-#ifdef _WIN32
-  return {10, 7, 1, 3};
-#else
-  return {6, 7, 9, 5};
-#endif
-}
+#include <algorithm>
 
+// xoshiro256** and the bounded draws are specified bit for bit: same values on every platform
 TEST(rand_n_values, values_are_correct_seed_0) {
   constexpr auto seed = 0;
   constexpr auto minVal = 0;
   constexpr auto maxVal = 10;
   constexpr auto nbValues = 4;
 
-  auto expectedValues = getExpectedValues();
+  std::vector<int> expectedValues = {4, 6, 1, 10};
 
   auto res = s3d::rand_n_unique_values(minVal, maxVal, nbValues, seed);
   EXPECT_EQ(res[0], expectedValues[0]);
@@ -26,3 +19,56 @@ TEST(rand_n_values, values_are_correct_seed_0) {
   EXPECT_EQ(res[2], expectedValues[2]);
   EXPECT_EQ(res[3], expectedValues[3]);
 }
+
+TEST(rand_n_values, whole_range_is_a_permutation) {
+  s3d::Xoshiro256 generator(3);
+  std::vector<int> values;
+  for (int i = 0; i < 20; ++i) {
+    s3d::rand_n_unique_values(5, 12, 8, &generator, &values);
+    std::sort(std::begin(values), std::end(values));
+    EXPECT_EQ(values, (std::vector<int>{5, 6, 7, 8, 9, 10, 11, 12}));
+  }
+}
+
+TEST(rand_n_values, values_are_unique_and_in_range) {
+  s3d::Xoshiro256 generator(5);
+  std::vector<int> values;
+  std::vector<int> histogram(10, 0);
+  for (int i = 0; i < 10000; ++i) {
+    s3d::rand_n_unique_values(0, 9, 3, &generator, &values);
+    ASSERT_EQ(values.size(), 3);
+    for (size_t j = 0; j < values.size(); ++j) {
+      ASSERT_GE(values[j], 0);
+      ASSERT_LE(values[j], 9);
+      EXPECT_EQ(std::count(std::begin(values), std::end(values), values[j]), 1);
+      ++histogram[values[j]];
+    }
+  }
+
+  // each value is drawn with probability 3 / 10
+  for (int count : histogram) {
+    EXPECT_NEAR(count, 3000, 200);
+  }
+}
+
+TEST(xoshiro256, streams_are_reproducible_and_distinct) {
+  s3d::Xoshiro256 stream0(42, 0), stream1(42, 1), stream1Again(42, 1);
+  s3d::Xoshiro256 jumped(42);
+  jumped.jump();
+
+  for (int i = 0; i < 100; ++i) {
+    auto value1 = stream1();
+    EXPECT_EQ(value1, stream1Again());
+    EXPECT_EQ(value1, jumped());
+    EXPECT_NE(value1, stream0());
+  }
+}
+
+TEST(xoshiro256, bounded_stays_in_range) {
+  s3d::Xoshiro256 generator(1);
+  for (uint64_t range : {1ULL, 2ULL, 3ULL, 1000ULL, (1ULL << 63U) + 1}) {
+    for (int i = 0; i < 1000; ++i) {
+      EXPECT_LT(generator.bounded(range), range);
+    }
+  }
+}
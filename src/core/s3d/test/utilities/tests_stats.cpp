@@ -2,7 +2,10 @@
 
 #include "s3d/utilities/stats.h"
 
+#include <algorithm>
+#include <cmath>
 #include <numeric>
+#include <random>
 
 TEST(percentile, first_last_elements) {
   std::vector<float> v;
@@ -73,4 +76,81 @@ TEST(online_variance, compare_results) {
   }
 
   EXPECT_DOUBLE_EQ(onlineVariance.getVariance(), goldVariance);
-}
\ No newline at end of file
+}
+std::vector<double> randomValues(size_t size, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+  std::vector<double> values(size);
+  for (auto& value : values) {
+    value = distribution(generator);
+  }
+  return values;
+}
+
+// reference: full sort, same interpolation as s3d::percentile
+double sortedPercentile(std::vector<double> values, float percentile) {
+  std::sort(std::begin(values), std::end(values));
+  float x = percentile * (static_cast<float>(values.size()) - 1.0f) + 1.0f;
+  auto index = static_cast<size_t>(std::floor(x));
+  float remainder = x - std::floor(x);
+  if (remainder < 0.00001f) {
+    return values[index - 1];
+  }
+  return values[index - 1] + remainder * (values[index] - values[index - 1]);
+}
+
+TEST(percentile, in_place_selection_matches_sorting) {
+  for (size_t size : {1, 2, 7, 100, 1001}) {
+    auto values = randomValues(size, static_cast<unsigned int>(size));
+    for (float p : {0.0f, 0.03f, 0.25f, 0.5f, 0.97f, 1.0f}) {
+      auto copy = values;
+      EXPECT_NEAR(s3d::percentile_in_place(std::begin(copy), std::end(copy), p),
+                  sortedPercentile(values, p), 1e-9);
+    }
+    auto copy = values;
+    EXPECT_DOUBLE_EQ(s3d::median_in_place(std::begin(copy), std::end(copy)),
+                     s3d::median(values));
+  }
+}
+
+TEST(quantiles, multiple_percentiles_in_one_pass) {
+  auto values = randomValues(1000, 42);
+  const std::vector<float> percentiles = {0.97f, 0.03f, 0.5f, 0.5f, 0.0f, 1.0f};
+
+  s3d::Quantiles<double> quantiles;
+  std::vector<double> results;
+  quantiles.percentiles(values, percentiles, &results);
+
+  ASSERT_EQ(results.size(), percentiles.size());
+  for (size_t i = 0; i < percentiles.size(); ++i) {
+    EXPECT_NEAR(results[i], sortedPercentile(values, percentiles[i]), 1e-9);
+  }
+
+  // buffers are reused with other sizes
+  values.resize(11);
+  quantiles.percentiles(values, {0.1f, 0.9f}, &results);
+  EXPECT_NEAR(results[0], sortedPercentile(values, 0.1f), 1e-9);
+  EXPECT_NEAR(results[1], sortedPercentile(values, 0.9f), 1e-9);
+  EXPECT_DOUBLE_EQ(quantiles.median(values), s3d::median(values));
+}
+
+TEST(streaming_quantile, exact_with_few_values) {
+  s3d::StreamingQuantile<double> quantile(0.5f);
+  quantile.update(3.0);
+  quantile.update(1.0);
+  quantile.update(2.0);
+  EXPECT_EQ(quantile.getCount(), 3);
+  EXPECT_DOUBLE_EQ(quantile.getQuantile(), 2.0);
+}
+
+TEST(streaming_quantile, close_to_exact_on_long_stream) {
+  auto values = randomValues(100000, 7);
+  for (float p : {0.03f, 0.5f, 0.97f}) {
+    s3d::StreamingQuantile<double> quantile(p);
+    for (auto value : values) {
+      quantile.update(value);
+    }
+    // values span 200
+    EXPECT_NEAR(quantile.getQuantile(), sortedPercentile(values, p), 1.0);
+  }
+}
@@ -38,20 +38,27 @@ std::unique_ptr<Disparities> DisparityAlgorithmBM::ComputeDisparities(
 
   // filter disparity map
 
-  // retrieve max and min values
+  // retrieve max and min values, 0 is no disparity
+  cv::cuda::GpuMat d_hasDisparity;
+  cv::cuda::compare(d_disp, cv::Scalar(0), d_hasDisparity, cv::CMP_NE);
   cv::Point minPos, maxPos;
-  double minVal, maxVal;
-  cv::cuda::minMaxLoc(d_disp, &minVal, &maxVal, &minPos, &maxPos);
+  double minVal = 0.0, maxVal = 0.0;
+  cv::cuda::minMaxLoc(d_disp, &minVal, &maxVal, &minPos, &maxPos, d_hasDisparity);
 
   d_disp.download(disp);
 
-  Image<uint8_t> dispImg(Size(disp.rows, disp.cols));
+  Image<uint8_t> dispImg(Size(disp.cols, disp.rows));
   cv::cv2eigen(disp, dispImg);
 
+  if (maxVal == 0.0) {
+    return std::make_unique<DisparitiesDense>(dispImg);
+  }
+
+  // map values are left - right columns, the largest one is the smallest disparity
   auto disparities = std::unique_ptr<Disparities>(std::make_unique<DisparitiesDense>(
       dispImg,
-      DisparityPoint{PixelPos{minPos.y, minPos.x}, PixelPos{0, int(minVal)}},
-      DisparityPoint{PixelPos{maxPos.y, maxPos.x}, PixelPos{0, int(maxVal)}}));
+      DisparityPoint{PixelPos{maxPos.y, maxPos.x}, PixelPos{0, -int(maxVal)}},
+      DisparityPoint{PixelPos{minPos.y, minPos.x}, PixelPos{0, -int(minVal)}}));
 
   return disparities;
 }
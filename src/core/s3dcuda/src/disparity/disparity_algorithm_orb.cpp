@@ -33,7 +33,7 @@ std::unique_ptr<Disparities> DisparityAlgorithmORB::ComputeDisparities(
 
   std::vector<std::vector<cv::DMatch>> knn_matches;
   auto matcher = cv::cuda::DescriptorMatcher::createBFMatcher(cv::NORM_HAMMING);
-  matcher->knnMatch(d_descriptors2, d_descriptors1, knn_matches, 2);
+  matcher->knnMatch(d_descriptors1, d_descriptors2, knn_matches, 2);
 
   std::vector<DisparityPoint> disparityPoints;
 
@@ -57,7 +57,7 @@ std::unique_ptr<Disparities> DisparityAlgorithmORB::ComputeDisparities(
   //        cv::imshow("imgRes", imgRes);
 
   auto disparities = std::unique_ptr<Disparities>(
-      std::make_unique<DisparitiesSparse>(disparityPoints, Size{left.rows, left.cols}));
+      std::make_unique<DisparitiesSparse>(disparityPoints, Size{left.cols, left.rows}));
 
   return disparities;
 }